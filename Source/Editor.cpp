@@ -5,7 +5,7 @@ namespace gui
 {
     Notify Editor::makeNotify(Editor& editor)
     {
-        return [&e = editor](EvtType evt, const void*)
+        return Notify({ EvtType::ColourSchemeChanged }, [&e = editor](EvtType evt, const void*)
         {
             if (evt == EvtType::ColourSchemeChanged)
             {
@@ -14,7 +14,7 @@ namespace gui
 
                 e.setMouseCursor(makeCursor(CursorType::Default));
             }
-        };
+        });
     }
 	
     Editor::Editor(audio::Processor& p) :
@@ -50,11 +50,9 @@ namespace gui
         toast(utils),
 
         bypassed(false),
-        shadr(utils, *this)
+        shadr(utils)
 
     {
-        setComponentEffect(&shadr);
-
         setMouseCursor(makeCursor(CursorType::Default));
 
         layout.init
@@ -93,12 +91,14 @@ namespace gui
 		
         addChildComponent(toast);
 
+        addChildComponent(shadr);
+
         updateBgImage(false);
 
         setOpaque(true);
         setResizable(true, true);
         {
-            const auto user = audioProcessor.props.getUserSettings();
+            const auto user = audioProcessor.props->getUserSettings();
             const auto w = user->getIntValue("gui/width", PPDEditorWidth);
             const auto h = user->getIntValue("gui/height", PPDEditorHeight);
             setSize(w, h);
@@ -107,7 +107,6 @@ namespace gui
 
     Editor::~Editor()
     {
-        setComponentEffect(nullptr);
     }
 
     void Editor::paint(Graphics& g)
@@ -147,6 +146,7 @@ namespace gui
 #endif
 
         tooltip.setBounds(layout.bottom().toNearestInt());
+        shadr.setBounds(getLocalBounds());
 
         const auto thicc = utils.thicc;
         editorKnobs.setBounds(0, 0, static_cast<int>(thicc * 42.f), static_cast<int>(thicc * 12.f));
@@ -156,7 +156,7 @@ namespace gui
         else
             updateBgImage(true);
 		
-        const auto user = utils.audioProcessor.props.getUserSettings();
+        const auto user = utils.audioProcessor.props->getUserSettings();
         const auto firstTime = user->getBoolValue("firstTimeUwU", true);
         if (firstTime)
         {
@@ -197,7 +197,7 @@ namespace gui
     {
         const auto w = getWidth();
         const auto h = getHeight();
-        auto user = audioProcessor.props.getUserSettings();
+        auto user = audioProcessor.props->getUserSettings();
         user->setValue("gui/width", w);
         user->setValue("gui/height", h);
     }
@@ -3,6 +3,9 @@
 
 #include "arch/Conversion.h"
 
+// runs the binary vs xml state benchmark once from the message thread
+#define DebugStateBenchmark false
+
 namespace audio
 {
     juce::AudioProcessorEditor* Processor::createEditor()
@@ -28,6 +31,7 @@ namespace audio
         juce::AudioProcessor(makeBusesProperties()),
         playHeadPos(),
         props(),
+        arena(),
         sus(*this),
         state(),
 #if PPDHasTuningEditor
@@ -50,26 +54,11 @@ namespace audio
 #if PPDHasLookahead
 		, lookaheadEnabled(false)
 #endif
-		, midiVoices(midiManager)
+		, midiVoices()
 #if PPDHasTuningEditor
         , tuningEditorSynth(xenManager)
 #endif
     {
-        {
-            juce::PropertiesFile::Options options;
-            options.applicationName = JucePlugin_Name;
-            options.filenameSuffix = ".settings";
-            options.folderName = "Mrugalla" + juce::File::getSeparatorString() + JucePlugin_Name;
-            options.osxLibrarySubFolder = "Application Support";
-            options.commonToAllUsers = false;
-            options.ignoreCaseOfKeyNames = false;
-            options.doNotSave = false;
-            options.millisecondsBeforeSaving = 20;
-            options.storageFormat = juce::PropertiesFile::storeAsXML;
-
-            props.setStorageParameters(options);
-        }
-        
         {
             playHeadPos.bpm = 120.;
             playHeadPos.ppqPosition = 0.;
@@ -82,9 +71,8 @@ namespace audio
 
     ProcessorBackEnd::~ProcessorBackEnd()
     {
-        auto user = props.getUserSettings();
+        auto user = props->getUserSettings();
         user->setValue("firstTimeUwU", false);
-        user->save();
     }
 
     const String ProcessorBackEnd::getName() const
@@ -154,12 +142,12 @@ namespace audio
 
     ProcessorBackEnd::AppProps* ProcessorBackEnd::getProps() noexcept
     {
-        return &props;
+        return &props.get();
     }
 
     void ProcessorBackEnd::savePatch()
     {
-        params.savePatch(props);
+        params.savePatch(*props);
         midiManager.savePatch();
 #if PPDHasTuningEditor
         tuningEditorSynth.savePatch(state);
@@ -168,7 +156,7 @@ namespace audio
 
     void ProcessorBackEnd::loadPatch()
     {
-        params.loadPatch(props);
+        params.loadPatch(*props);
         midiManager.loadPatch();
 #if PPDHasTuningEditor
         tuningEditorSynth.loadPatch(state);
@@ -187,6 +175,18 @@ namespace audio
 
     void ProcessorBackEnd::timerCallback()
     {
+#if JUCE_DEBUG && DebugStateBenchmark
+        static bool benchmarked = false;
+        if (!benchmarked)
+        {
+            benchmarked = true;
+            const auto numRuns = 100;
+            const auto b = state.benchmark(*this, numRuns);
+            DBG("state benchmark, " << numRuns << " runs:");
+            DBG("binary: " << b.binBytes << " bytes, save " << b.binSaveMs << " ms, load " << b.binLoadMs << " ms");
+            DBG("xml: " << b.xmlBytes << " bytes, save " << b.xmlSaveMs << " ms, load " << b.xmlLoadMs << " ms");
+        }
+#endif
         bool shallForcePrepare = false;
 #if PPDHasHQ
         const auto ovsrEnabled = params[PID::HQ]->getValMod() > .5f;
@@ -207,8 +207,14 @@ namespace audio
 
     void ProcessorBackEnd::processBlockBypassed(AudioBuffer& buffer, juce::MidiBuffer&)
     {
+        // keeps the modulation going for the gui, but no dsp consumes this snapshot's change bits
         macroProcessor();
+        macroProcessor.invalidate();
+        processBypass(buffer);
+    }
 
+    void ProcessorBackEnd::processBypass(AudioBuffer& buffer) noexcept
+    {
         auto mainBus = getBus(true, 0);
         auto mainBuffer = mainBus->getBusBuffer(buffer);
 
@@ -229,12 +235,50 @@ namespace audio
         meters.processOut(constSamples, numChannels, numSamples);
     }
 
+    // PERLIN PARAMS
+
+    PerlinParams::PerlinParams() :
+        rateHz(2.),
+        rateBeats(.25),
+        octaves(1.f),
+        width(0.f),
+        phase(0.f),
+        shape(Perlin::Shape::Spline),
+        temposync(false),
+        procedural(true),
+        omni(false),
+        outputToCC(false)
+    {
+    }
+
+    void PerlinParams::operator()(const ParamsSnapshot& snap) noexcept
+    {
+        if (!snap.hasChanged(PID::RateHz, PID::OutputType))
+            return;
+
+        rateHz = static_cast<double>(snap.getValModDenorm(PID::RateHz));
+        rateBeats = static_cast<double>(snap.getValModDenorm(PID::RateBeats));
+        octaves = snap.getValModDenorm(PID::Octaves);
+        width = snap.getValMod(PID::Width);
+        temposync = snap.getValMod(PID::RateType) > .5f;
+        phase = snap.getValModDenorm(PID::Phase);
+        shape = static_cast<Perlin::Shape>(static_cast<int>(std::round(snap.getValModDenorm(PID::Shape))));
+        procedural = snap.getValMod(PID::RandType) > .5f;
+        omni = snap.getValMod(PID::Orientation) < .5f;
+        outputToCC = snap.getValMod(PID::OutputType) > .5f;
+    }
+
     // PROCESSOR
 
     Processor::Processor() :
         ProcessorBackEnd(),
         scope(),
-        perlin()
+        perlin(),
+        perlinParams(),
+        modMatrix(params, state),
+        noteTrigger(),
+        shaper(),
+        processing(false)
 	{
     }
 
@@ -257,12 +301,15 @@ namespace audio
         const auto sampleRateUpF = static_cast<float>(sampleRateUp);
         const auto sampleRateF = static_cast<float>(sampleRate);
 
-        midiVoices.prepare(blockSizeUp);
+        arena.begin();
+        midiVoices.prepare(blockSizeUp, arena);
 #if PPDHasTuningEditor
 		tuningEditorSynth.prepare(sampleRateF, maxBlockSize);
 #endif
 
-        perlin.prepare(sampleRateUpF, blockSizeUp);
+        perlin.prepare(sampleRateUpF, blockSizeUp, arena);
+        modMatrix.prepare(sampleRateUpF, blockSizeUp, arena);
+        arena.end();
         for(auto& s: scope)
             s.prepare(sampleRateUp, blockSizeUp);
 
@@ -270,37 +317,53 @@ namespace audio
         dryWetMix.prepare(sampleRateF, maxBlockSize, latencyInt);
         meters.prepare(sampleRateF, maxBlockSize);
         setLatencySamples(latencyInt);
+        macroProcessor.invalidate();
         sus.prepareToPlay();
+        processing.store(false);
     }
 
     void Processor::processBlock(AudioBuffer& buffer, MIDIBuffer& midi)
     {
         const ScopedNoDenormals noDenormals;
+        processing.store(true);
 
-        macroProcessor();
+        const auto& snap = macroProcessor();
 
         auto mainBus = getBus(true, 0);
         auto mainBuffer = mainBus->getBusBuffer(buffer);
         
+        // blocks that leave early drop the snapshot's change bits, so the next one re-reports everything
         if (sus.suspendIfNeeded(mainBuffer))
+        {
+            macroProcessor.invalidate();
             return;
+        }
 
         const auto numSamples = mainBuffer.getNumSamples();
         if (numSamples == 0)
+        {
+            macroProcessor.invalidate();
             return;
+        }
 
 #if PPDHasTuningEditor
-        xenManager
-        (
-            std::round(params[PID::Xen]->getValModDenorm()),
-            params[PID::MasterTune]->getValModDenorm(),
-            std::round(params[PID::BaseNote]->getValModDenorm())
-        );
-
-
-        midiVoices.pitchbendRange = std::round(params[PID::PitchbendRange]->getValModDenorm());
+        if (snap.hasChanged(PID::Xen, PID::PitchbendRange))
+        {
+            xenManager
+            (
+                std::round(snap.getValModDenorm(PID::Xen)),
+                snap.getValModDenorm(PID::MasterTune),
+                std::round(snap.getValModDenorm(PID::BaseNote))
+            );
+
+            midiVoices.pitchbendRange = std::round(snap.getValModDenorm(PID::PitchbendRange));
+        }
 #endif	
-        midiManager(midi, numSamples);
+        noteTrigger.mode = static_cast<NoteTrigger::Retrig>(static_cast<int>(std::round(snap.getValModDenorm(PID::RetrigMode))));
+        noteTrigger.channel = static_cast<int>(std::round(snap.getValModDenorm(PID::RetrigChannel)));
+        noteTrigger.keyLow = static_cast<int>(std::round(snap.getValModDenorm(PID::RetrigKeyLow)));
+        noteTrigger.keyHigh = static_cast<int>(std::round(snap.getValModDenorm(PID::RetrigKeyHigh)));
+        midiManager(midi, numSamples, midiVoices, modMatrix, noteTrigger);
 		
         const auto _playHead = getPlayHead();
         const auto _playHeadPos = _playHead->getPosition();
@@ -313,9 +376,26 @@ namespace audio
 			playHeadPos.isPlaying = _playHeadPos->getIsPlaying();
 			playHeadPos.timeInSamples = *_playHeadPos->getTimeInSamples();
         }
+        // the perlin tells loop wraps from jumps by the loop points
+        const auto loopPoints = playHeadValid ? _playHeadPos->getLoopPoints() : juce::Optional<juce::AudioPlayHead::LoopPoints>();
+        if (loopPoints && _playHeadPos->getIsLooping())
+        {
+            playHeadPos.isLooping = true;
+            playHeadPos.ppqLoopStart = loopPoints->ppqStart;
+            playHeadPos.ppqLoopEnd = loopPoints->ppqEnd;
+        }
+        else
+        {
+            playHeadPos.isLooping = false;
+            playHeadPos.ppqLoopStart = 0.;
+            playHeadPos.ppqLoopEnd = 0.;
+        }
 
-        if (params[PID::Power]->getValMod() < .5f)
-            return processBlockBypassed(buffer, midi);
+        if (snap.getValMod(PID::Power) < .5f)
+        {
+            macroProcessor.invalidate();
+            return processBypass(buffer);
+        }
 
         const auto samples = mainBuffer.getArrayOfWritePointers();
 #if PPDHasGainIn || PPDHasGainOut
@@ -324,7 +404,7 @@ namespace audio
         const auto numChannels = mainBuffer.getNumChannels();
 
 #if PPD_MixOrGainDry
-        bool muteDry = params[PID::MuteDry]->getValMod() > .5f;
+        bool muteDry = snap.getValMod(PID::MuteDry) > .5f;
 #endif
         dryWetMix.saveDry
         (
@@ -334,18 +414,18 @@ namespace audio
 #if PPDHasGainIn
             params[PID::GainIn]->getValueDenorm(),
 #if PPDHasUnityGain
-            params[PID::UnityGain]->getValMod(),
+            snap.getValMod(PID::UnityGain),
 #endif
 #endif
 #if PPD_MixOrGainDry == 0
-            params[PID::Mix]->getValMod()
+            snap.getValMod(PID::Mix)
 #else
-			, params[PID::Mix]->getValModDenorm()
+			, snap.getValModDenorm(PID::Mix)
 #endif
 #if PPDHasGainOut
-            , params[PID::Gain]->getValModDenorm()
+            , snap.getValModDenorm(PID::Gain)
 #if PPDHasPolarity
-            , (params[PID::Polarity]->getValMod() > .5f ? -1.f : 1.f)
+            , (snap.getValMod(PID::Polarity) > .5f ? -1.f : 1.f)
 #endif
 #endif
         );
@@ -355,7 +435,7 @@ namespace audio
 #endif
 
 #if PPDHasStereoConfig
-        midSideEnabled = numChannels == 2 && params[PID::StereoConfig]->getValMod() > .5f;
+        midSideEnabled = numChannels == 2 && snap.getValMod(PID::StereoConfig) > .5f;
         if (midSideEnabled)
         {
             encodeMS(samples, numSamples, 0);
@@ -427,7 +507,7 @@ namespace audio
 #endif
 #if PPDHasClipper
         {
-            const auto isClipping = params[PID::Clipper]->getValMod() > .5f ? 1.f : 0.f;
+            const auto isClipping = snap.getValMod(PID::Clipper) > .5f ? 1.f : 0.f;
             if (isClipping)
             {
                 for (auto ch = 0; ch < numChannels; ++ch)
@@ -448,7 +528,7 @@ namespace audio
             numChannels,
             numSamples
 #if PPDHasDelta
-            , params[PID::Delta]->getValMod() > .5f
+            , snap.getValMod(PID::Delta) > .5f
 #endif
         );
 
@@ -480,37 +560,53 @@ namespace audio
 
     void Processor::processBlockUpsampled(float* const* samples, int numChannels, int numSamples
 #if PPDHasSidechain
-        , float**, int
+        , float** samplesSC, int numChannelsSC
 #endif
     ) noexcept
     {
-        const auto rateHz = params[PID::RateHz]->getValModDenorm();
-        const auto rateBeats = params[PID::RateBeats]->getValModDenorm();
-        const auto oct = params[PID::Octaves]->getValModDenorm();
-        const auto width = params[PID::Width]->getValMod();
-        const auto rateType = params[PID::RateType]->getValMod() > .5f;
-        const auto phase = params[PID::Phase]->getValModDenorm();
-        const auto shape = static_cast<int>(std::round(params[PID::Shape]->getValModDenorm()));
-        const auto procedural = params[PID::RandType]->getValMod() > .5f;
-		
+        const auto& snap = macroProcessor.getSnapshot();
+        perlinParams(snap);
+        const auto& pp = perlinParams;
+
+        // the input gets replaced by the perlin noise, so it's the envelope's source without sidechain
+        const auto& mod = modMatrix
+        (
+#if PPDHasSidechain
+            samplesSC,
+            numChannelsSC,
+#else
+            samples,
+            numChannels,
+#endif
+            numSamples,
+            snap,
+            perlin,
+            pp.temposync
+        );
+
         perlin
         (
             samples,
             numChannels,
             numSamples,
             playHeadPos,
-            static_cast<double>(rateHz),
-            static_cast<double>(rateBeats),
-            oct,
-            width,
-            phase,
-            static_cast<Perlin::Shape>(shape),
-            rateType,
-            procedural
+            pp.rateHz,
+            pp.rateBeats,
+            pp.octaves,
+            pp.width,
+            pp.phase,
+            pp.shape,
+            pp.temposync,
+            pp.procedural,
+            mod,
+            noteTrigger.getTriggers(numSamples),
+            noteTrigger.getNumTriggers(),
+            noteTrigger.mode
         );
 
-        const auto omnidirectional = params[PID::Orientation]->getValMod() < .5f;
-        if (omnidirectional)
+        shaper(samples, numChannels, numSamples);
+
+        if (pp.omni)
         {
             for (auto ch = 0; ch < numChannels; ++ch)
             {
@@ -531,10 +627,9 @@ namespace audio
     void Processor::processBlockDownsampled(float* const* samples, int numChannels, int numSamples,
         MIDIBuffer& midi) noexcept
     {
-        const auto outputToCC = params[PID::OutputType]->getValMod() > .5f;
-        if (outputToCC)
+        if (perlinParams.outputToCC)
         {
-            const auto omni = params[PID::Orientation]->getValMod() < .5f;
+            const auto omni = perlinParams.omni;
             
             const auto stepSize = 8;
             if(omni)
@@ -559,7 +654,10 @@ namespace audio
         }
     }
 
-    void Processor::releaseResources() {}
+    void Processor::releaseResources()
+    {
+        processing.store(false);
+    }
 
     /////////////////////////////////////////////
     /////////////////////////////////////////////;
@@ -577,9 +675,14 @@ namespace audio
 
     void Processor::savePatch()
     {
+        // one save is one undo step
+        state.beginTransaction();
         auto perlinSeed = perlin.seed.load();
         state.set("perlin", "seed", perlinSeed);
+        modMatrix.savePatch();
+        shaper.savePatch(state);
         ProcessorBackEnd::savePatch();
+        state.endTransaction();
     }
 
     void Processor::loadPatch()
@@ -588,10 +691,12 @@ namespace audio
         if (perlinSeedVar)
         {
             const auto perlinSeed = static_cast<int>(*perlinSeedVar);
-			perlin.setSeed(perlinSeed);
+            // only crossfade during playback, a project load or offline render starts on the patch's noise
+			perlin.setSeed(perlinSeed, processing.load());
         }
+        modMatrix.loadPatch();
+        shaper.loadPatch(state);
         ProcessorBackEnd::loadPatch();
-        forcePrepareToPlay();
     }
 }
 
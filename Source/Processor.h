@@ -3,10 +3,12 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_events/juce_events.h>
 
+#include "arch/Settings.h"
 #include "audio/XenManager.h"
 #include "audio/MIDIManager.h"
 #include "audio/MIDILearn.h"
 #include "audio/ProcessSuspend.h"
+#include "audio/ScratchArena.h"
 #include "audio/DryWetMix.h"
 #if PPDHasStereoConfig
 #include "audio/MidSide.h"
@@ -19,10 +21,14 @@
 
 #include "audio/Oscilloscope.h"
 #include "audio/PerlinNoise.h"
+#include "audio/ModMatrix.h"
+#include "audio/NoteTrigger.h"
+#include "audio/Shaper.h"
 
 namespace audio
 {
     using MacroProcessor = param::MacroProcessor;
+    using ParamsSnapshot = param::ParamsSnapshot;
     using Timer = juce::Timer;
 
     struct ProcessorBackEnd :
@@ -30,7 +36,7 @@ namespace audio
         public Timer
     {
         using ChannelSet = juce::AudioChannelSet;
-        using AppProps = juce::ApplicationProperties;
+        using AppProps = sta::Settings;
 
         ProcessorBackEnd();
 		~ProcessorBackEnd();
@@ -57,7 +63,10 @@ namespace audio
         juce::AudioProcessor::BusesProperties makeBusesProperties();
 
         PlayHeadPos playHeadPos;
-        AppProps props;
+        // shared by all instances
+        juce::SharedResourcePointer<AppProps> props;
+        // per-block scratch memory, handed out in prepareToPlay
+        ScratchArena arena;
         ProcessSuspender sus;
 
         XenManager xenManager;
@@ -81,6 +90,9 @@ namespace audio
 
         void processBlockBypassed(AudioBuffer&, juce::MidiBuffer&) override;
 
+        // the dry signal and meters of a bypassed block, without taking a snapshot
+        void processBypass(AudioBuffer&) noexcept;
+
 #if PPDHasStereoConfig
         bool midSideEnabled;
 #endif
@@ -91,6 +103,20 @@ namespace audio
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProcessorBackEnd)
     };
 
+    // the perlin-related values of a snapshot, only re-derived if one of them changed.
+    struct PerlinParams
+    {
+        PerlinParams();
+
+        /* snapshot */
+        void operator()(const ParamsSnapshot&) noexcept;
+
+        double rateHz, rateBeats;
+        float octaves, width, phase;
+        Perlin::Shape shape;
+        bool temposync, procedural, omni, outputToCC;
+    };
+
     struct Processor :
         public ProcessorBackEnd
     {
@@ -131,5 +157,11 @@ namespace audio
 
         std::array<Oscilloscope, 2> scope;
         Perlin2 perlin;
+        PerlinParams perlinParams;
+        ModMatrix modMatrix;
+        NoteTrigger noteTrigger;
+        Shaper shaper;
+        // true from the first block after prepareToPlay until releaseResources
+        std::atomic<bool> processing;
     };
 }
\ No newline at end of file
@@ -1,8 +1,10 @@
 #include "FormulaParser2.h"
 #include <random>
+#include <juce_audio_basics/juce_audio_basics.h>
 
 namespace fx
 {
+	using SIMD = juce::FloatVectorOperations;
 	using MersenneTwister = std::mt19937;
 	using RandDistribution = std::uniform_real_distribution<float>;
 	
@@ -62,6 +64,8 @@ namespace fx
 			return "Unknown Token.";
 		case ParserErrorType::WroteAmountOfArguments:
 			return "Wrote Amount Of Arguments.";
+		case ParserErrorType::TooComplex:
+			return "Too Complex.";
 		default: return "Unknown Error.";
 		}
 	}
@@ -333,104 +337,81 @@ namespace fx
 		return "";
 	}
 
-	Func getFunc(Operator o)
+	float applyUnary(Operator o, float v) noexcept
 	{
 		switch (o)
 		{
-		case Operator::Asinh:
-			return [](float v) { return std::asinh(v); };
-		case Operator::Acosh:
-			return [](float v) { return std::acosh(v); };
-		case Operator::Atanh:
-			return [](float v) { return std::atanh(v); };
-		case Operator::Floor:
-			return [](float v) { return std::floor(v); };
-		case Operator::Log10:
-			return [](float v) { return std::log10(v); };
+		case Operator::Asinh: return std::asinh(v);
+		case Operator::Acosh: return std::acosh(v);
+		case Operator::Atanh: return std::atanh(v);
+		case Operator::Floor: return std::floor(v);
+		case Operator::Log10: return std::log10(v);
 		case Operator::Noise:
-			return [](float seed)
-			{
-				MersenneTwister mt(static_cast<unsigned int>(seed));
-				RandDistribution dist(-1.f, 1.f);
+		{
+			MersenneTwister mt(static_cast<unsigned int>(v));
+			RandDistribution dist(-1.f, 1.f);
 
-				return dist(mt) * 2.f - 1.f;
-			};
-		case Operator::Asin:
-			return [](float v) { return std::asin(v); };
-		case Operator::Acos:
-			return [](float v) { return std::acos(v); };
-		case Operator::Atan:
-			return [](float v) { return std::atan(v); };
-		case Operator::Ceil:
-			return [](float v) { return std::ceil(v); };
-		case Operator::Cosh:
-			return [](float v) { return std::cosh(v); };
-		case Operator::Log2:
-			return [](float v) { return std::log2(v); };
-		case Operator::Sinh:
-			return [](float v) { return std::sinh(v); };
-		case Operator::Sign:
-			return [](float v) { return std::signbit(v) ? -1.f : 1.f; };
-		case Operator::Sqrt:
-			return [](float v) { return std::sqrt(v); };
-		case Operator::Tanh:
-			return [](float v) { return std::tanh(v); };
-		case Operator::Abs:
-			return [](float v) { return std::abs(v); };
-		case Operator::Cos:
-			return [](float v) { return std::cos(v); };
-		case Operator::Exp:
-			return [](float v) { return std::exp(v); };
-		case Operator::Sin:
-			return [](float v) { return std::sin(v); };
-		case Operator::Tan:
-			return [](float v) { return std::tan(v); };
-		case Operator::Log:
-			return [](float v) { return std::log(v); };
-		case Operator::Ln:
-			return [](float v) { return std::log(v); };
-		default:
-			return nullptr;
+			return dist(mt) * 2.f - 1.f;
+		}
+		case Operator::Asin: return std::asin(v);
+		case Operator::Acos: return std::acos(v);
+		case Operator::Atan: return std::atan(v);
+		case Operator::Ceil: return std::ceil(v);
+		case Operator::Cosh: return std::cosh(v);
+		case Operator::Log2: return std::log2(v);
+		case Operator::Sinh: return std::sinh(v);
+		case Operator::Sign: return std::signbit(v) ? -1.f : 1.f;
+		case Operator::Sqrt: return std::sqrt(v);
+		case Operator::Tanh: return std::tanh(v);
+		case Operator::Abs: return std::abs(v);
+		case Operator::Cos: return std::cos(v);
+		case Operator::Exp: return std::exp(v);
+		case Operator::Sin: return std::sin(v);
+		case Operator::Tan: return std::tan(v);
+		case Operator::Log: return std::log(v);
+		case Operator::Ln: return std::log(v);
+		default: return 0.f;
 		}
 	}
 
-	Func2 getFunc2(Operator o)
+	float applyBinary(Operator o, float a, float b) noexcept
 	{
 		switch (o)
 		{
-		case Operator::Plus:
-			return [](float a, float b) { return a + b; };
-		case Operator::Minus:
-			return [](float a, float b) { return a - b; };
-		case Operator::Multiply:
-			return [](float a, float b) { return a * b; };
+		case Operator::Plus: return a + b;
+		case Operator::Minus: return a - b;
+		case Operator::Multiply: return a * b;
 		case Operator::Divide:
-			return [](float a, float b)
-			{
-				if (b == 0.f)
-					b = std::numeric_limits<float>::min();
-				return a / b;
-			};
+			if (b == 0.f)
+				b = std::numeric_limits<float>::min();
+			return a / b;
 		case Operator::Modulo:
-			return [](float a, float b)
-			{
-				if (b == 0.f)
-					b = std::numeric_limits<float>::min();
-				return std::fmod(a, b);
-			};
+			if (b == 0.f)
+				b = std::numeric_limits<float>::min();
+			return std::fmod(a, b);
 		case Operator::Power:
-			return [](float a, float b)
-			{
-				if (a == 0.f)
-					if (b < 0.f)
-						a = std::numeric_limits<float>::min();
-				return std::pow(a, b);
-			};
-		default:
-			return nullptr;
+			if (a == 0.f)
+				if (b < 0.f)
+					a = std::numeric_limits<float>::min();
+			return std::pow(a, b);
+		default: return 0.f;
 		}
 	}
 
+	Func getFunc(Operator o)
+	{
+		if (getNumArguments(o) != 1)
+			return nullptr;
+		return [o](float v) { return applyUnary(o, v); };
+	}
+
+	Func2 getFunc2(Operator o)
+	{
+		if (getNumArguments(o) != 2)
+			return nullptr;
+		return [o](float a, float b) { return applyBinary(o, a, b); };
+	}
+
 	// Token
 	
 	Token::Token(Type _type, const String& text) :
@@ -583,11 +564,191 @@ namespace fx
 			}
 	}
 
+	// Program
+
+	namespace
+	{
+		/* op, a, numSamples */
+		void applyUnary(Operator o, float* a, int numSamples) noexcept
+		{
+			switch (o)
+			{
+			case Operator::Abs:
+				return SIMD::abs(a, a, numSamples);
+			default:
+				for (auto s = 0; s < numSamples; ++s)
+					a[s] = applyUnary(o, a[s]);
+				return;
+			}
+		}
+
+		/* op, a, b, numSamples */
+		void applyBinary(Operator o, float* a, const float* b, int numSamples) noexcept
+		{
+			switch (o)
+			{
+			case Operator::Plus:
+				return SIMD::add(a, b, numSamples);
+			case Operator::Minus:
+				return SIMD::subtract(a, b, numSamples);
+			case Operator::Multiply:
+				return SIMD::multiply(a, b, numSamples);
+			default:
+				for (auto s = 0; s < numSamples; ++s)
+					a[s] = applyBinary(o, a[s], b[s]);
+				return;
+			}
+		}
+	}
+
+	Program::Program() :
+		instructions(),
+		registers(),
+		maxDepth(0)
+	{}
+
+	ParserErrorType Program::compile(const Tokens& postfix)
+	{
+		std::vector<Instruction> program;
+		program.reserve(postfix.size());
+		auto depth = 0;
+		auto nMaxDepth = 0;
+
+		const auto isConst = [&program](int i)
+		{
+			return program[program.size() - i].code == OpCode::Const;
+		};
+
+		for (const auto& p : postfix)
+		{
+			switch (p.type)
+			{
+			case Token::Type::Number:
+				program.push_back({ OpCode::Const, Operator::NumOperators, p.value });
+				++depth;
+				break;
+			case Token::Type::X:
+				program.push_back({ OpCode::X, Operator::NumOperators, p.value });
+				++depth;
+				break;
+			case Token::Type::Operator:
+				if (depth < p.numArguments)
+					return ParserErrorType::WroteAmountOfArguments;
+
+				if (p.numArguments == 1)
+				{
+					if (isConst(1))
+						program.back().value = applyUnary(p.op, program.back().value);
+					else
+						program.push_back({ OpCode::Unary, p.op, 0.f });
+				}
+				else if (p.numArguments == 2)
+				{
+					if (isConst(1) && isConst(2))
+					{
+						const auto b = program.back().value;
+						program.pop_back();
+						program.back().value = applyBinary(p.op, program.back().value, b);
+					}
+					else
+						program.push_back({ OpCode::Binary, p.op, 0.f });
+					--depth;
+				}
+				break;
+			default:
+				return ParserErrorType::UnknownToken;
+			}
+
+			nMaxDepth = std::max(nMaxDepth, depth);
+			if (nMaxDepth > MaxDepth)
+				return ParserErrorType::TooComplex;
+		}
+
+		instructions = program;
+		maxDepth = nMaxDepth;
+		registers.resize(maxDepth * ChunkSize);
+		return ParserErrorType::NoError;
+	}
+
+	float Program::operator()(float x) const noexcept
+	{
+		std::array<float, MaxDepth> stack;
+		auto depth = 0;
+
+		for (const auto& i : instructions)
+		{
+			switch (i.code)
+			{
+			case OpCode::Const:
+				stack[depth++] = i.value;
+				break;
+			case OpCode::X:
+				stack[depth++] = x * i.value;
+				break;
+			case OpCode::Unary:
+				stack[depth - 1] = applyUnary(i.op, stack[depth - 1]);
+				break;
+			case OpCode::Binary:
+				--depth;
+				stack[depth - 1] = applyBinary(i.op, stack[depth - 1], stack[depth]);
+				break;
+			default:
+				break;
+			}
+		}
+
+		// like the interpreter this returns the last result
+		return depth > 0 ? stack[depth - 1] : 0.f;
+	}
+
+	void Program::operator()(float* dest, const float* x, int numSamples) noexcept
+	{
+		if (instructions.empty())
+			return SIMD::clear(dest, numSamples);
+
+		for (auto start = 0; start < numSamples; start += ChunkSize)
+		{
+			const auto n = std::min(ChunkSize, numSamples - start);
+			const auto xChunk = x + start;
+			auto depth = 0;
+
+			for (const auto& i : instructions)
+			{
+				auto reg = registers.data() + depth * ChunkSize;
+				switch (i.code)
+				{
+				case OpCode::Const:
+					SIMD::fill(reg, i.value, n);
+					++depth;
+					break;
+				case OpCode::X:
+					SIMD::copyWithMultiply(reg, xChunk, i.value, n);
+					++depth;
+					break;
+				case OpCode::Unary:
+					applyUnary(i.op, reg - ChunkSize, n);
+					break;
+				case OpCode::Binary:
+					applyBinary(i.op, reg - 2 * ChunkSize, reg - ChunkSize, n);
+					--depth;
+					break;
+				default:
+					break;
+				}
+			}
+
+			if (depth > 0)
+				SIMD::copy(dest + start, registers.data() + (depth - 1) * ChunkSize, n);
+			else
+				SIMD::clear(dest + start, n);
+		}
+	}
+
 	// Parser
 
 	Parser::Parser() :
 		errorType(ParserErrorType::NoError),
-		func([](float) { return 0.f; })
+		program()
 	{
 	}
 
@@ -764,52 +925,11 @@ namespace fx
 		DBG(toString(postfix));
 #endif
 
-		// CREATE FUNCTION
-		func = [this, postfix](float x)
-		{
-			Tokens stack;
-			float y = 0.f;
-			for (const auto& p : postfix)
-			{
-				switch (p.type)
-				{
-				case Token::Type::Number:
-					y = p.value;
-					stack.push_back(p);
-					break;
-				case Token::Type::X:
-					y = x * p.value;
-					stack.push_back({ Token::Type::Number, String(y) });
-					break;
-				case Token::Type::Operator:
-					if (stack.size() < p.numArguments)
-					{
-						errorType = ParserErrorType::WroteAmountOfArguments;
-						return 0.f;
-					}
-
-					if (p.numArguments == 1)
-						y = p.func(stack.back().value);
-					else if (p.numArguments == 2)
-						y = p.func2(stack[stack.size() - 2].value, stack.back().value);
-
-					for (auto i = 0; i < p.numArguments; ++i)
-						stack.pop_back();
-
-					stack.push_back({ Token::Type::Number, String(y) });
-					break;
-				default:
-					errorType = ParserErrorType::UnknownToken;
-					return 0.f;
-				}
-			}
-
-			if (std::isnan(y) || std::isinf(y))
-				return 0.f;
-			return y;
-		};
+		// COMPILE
+		errorType = program.compile(postfix);
+		if (errorType != ParserErrorType::NoError)
+			return false;
 
-		errorType = ParserErrorType::NoError;
 #if JUCE_DEBUG && DebugFormularParser
 		DBG("\nerr: " << toString(errorType));
 #endif
@@ -818,7 +938,18 @@ namespace fx
 
 	float Parser::operator()(float x) const noexcept
 	{
-		return func(x);
+		const auto y = program(x);
+		if (std::isnan(y) || std::isinf(y))
+			return 0.f;
+		return y;
+	}
+
+	void Parser::operator()(float* dest, const float* x, int numSamples) noexcept
+	{
+		program(dest, x, numSamples);
+		for (auto s = 0; s < numSamples; ++s)
+			if (std::isnan(dest[s]) || std::isinf(dest[s]))
+				dest[s] = 0.f;
 	}
 
 }
\ No newline at end of file
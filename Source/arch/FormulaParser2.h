@@ -30,6 +30,7 @@ namespace fx
 		MismatchedParenthesis,
 		UnknownToken,
 		WroteAmountOfArguments,
+		TooComplex,
 		NumTypes
 	};
 
@@ -83,6 +84,12 @@ namespace fx
 	/* txt, idx */
 	String getOperator(const String&, int&);
 
+	/* op, a */
+	float applyUnary(Operator, float) noexcept;
+
+	/* op, a, b */
+	float applyBinary(Operator, float, float) noexcept;
+
 	Func getFunc(Operator);
 	
 	Func2 getFunc2(Operator);
@@ -130,6 +137,41 @@ namespace fx
 	/* postfix, numElements, likelyX, numMin, numMax */
 	void generateTerm(Tokens&, int, float, float, float);
 
+	// a postfix term compiled to a flat stack program.
+	// constant subterms are folded while compiling.
+	// the block evaluator runs each instruction across a chunk of samples.
+	struct Program
+	{
+		enum class OpCode { Const, X, Unary, Binary, NumOpCodes };
+
+		struct Instruction
+		{
+			OpCode code;
+			Operator op;
+			// the constant, or the multiplier of x
+			float value;
+		};
+
+		static constexpr int MaxDepth = 32;
+		static constexpr int ChunkSize = 64;
+
+		Program();
+
+		/* postfix */
+		ParserErrorType compile(const Tokens&);
+
+		/* x */
+		float operator()(float) const noexcept;
+
+		/* dest, x, numSamples. dest may be x */
+		void operator()(float*, const float*, int) noexcept;
+
+		std::vector<Instruction> instructions;
+	protected:
+		std::vector<float> registers;
+		int maxDepth;
+	};
+
 	struct Parser
 	{
 		Parser();
@@ -141,10 +183,13 @@ namespace fx
 		
 		/* x */
 		float operator()(float = 0.f) const noexcept;
+
+		/* dest, x, numSamples. dest may be x */
+		void operator()(float*, const float*, int) noexcept;
 		
 		ParserErrorType errorType;
 	protected:
-		Func func;
+		Program program;
 	};
 }
 
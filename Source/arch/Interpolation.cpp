@@ -1,4 +1,5 @@
 #include "Interpolation.h"
+#include <algorithm>
 
 namespace interpolate
 {
@@ -45,40 +46,69 @@ namespace interpolate
 		if (i0 < 0) i0 += size;
 
 		const auto t = readHead - iFloor;
-		const auto v0 = buffer[i0];
-		const auto v1 = buffer[i1];
-		const auto v2 = buffer[i2];
-		const auto v3 = buffer[i3];
+		return kernel::cubicHermiteSpline(buffer[i0], buffer[i1], buffer[i2], buffer[i3], t);
+	}
 
-		const auto c0 = v1;
-		const auto c1 = static_cast<T>(.5) * (v2 - v0);
-		const auto c2 = v0 - static_cast<T>(2.5) * v1 + static_cast<T>(2.) * v2 - static_cast<T>(.5) * v3;
-		const auto c3 = static_cast<T>(1.5) * (v1 - v2) + static_cast<T>(.5) * (v3 - v0);
+	template<typename T>
+	T cubicHermiteSpline(const T* buffer, T readHead) noexcept
+	{
+		const auto iFloor = std::floor(readHead);
+		const auto i0 = static_cast<int>(iFloor);
 
-		return ((c3 * t + c2) * t + c1) * t + c0;
+		const auto t = readHead - iFloor;
+		return kernel::cubicHermiteSpline(buffer[i0], buffer[i0 + 1], buffer[i0 + 2], buffer[i0 + 3], t);
 	}
 
 	template<typename T>
-	T cubicHermiteSpline(const T* buffer, T readHead) noexcept
+	T lagrange4(const T* buffer, T readHead, int size) noexcept
+	{
+		const auto iFloor = std::floor(readHead);
+		auto i1 = static_cast<int>(iFloor);
+		auto i0 = i1 - 1;
+		auto i2 = i1 + 1;
+		auto i3 = i1 + 2;
+		if (i3 >= size) i3 -= size;
+		if (i2 >= size) i2 -= size;
+		if (i0 < 0) i0 += size;
+
+		const auto t = readHead - iFloor;
+		return kernel::lagrange4(buffer[i0], buffer[i1], buffer[i2], buffer[i3], t);
+	}
+
+	template<typename T>
+	T lagrange4(const T* buffer, T readHead) noexcept
 	{
 		const auto iFloor = std::floor(readHead);
-		auto i0 = static_cast<int>(iFloor);
-		auto i1 = i0 + 1;
-		auto i2 = i0 + 2;
-		auto i3 = i0 + 3;
+		const auto i0 = static_cast<int>(iFloor);
 
 		const auto t = readHead - iFloor;
-		const auto v0 = buffer[i0];
-		const auto v1 = buffer[i1];
-		const auto v2 = buffer[i2];
-		const auto v3 = buffer[i3];
+		return kernel::lagrange4(buffer[i0], buffer[i0 + 1], buffer[i0 + 2], buffer[i0 + 3], t);
+	}
 
-		const auto c0 = v1;
-		const auto c1 = static_cast<T>(.5) * (v2 - v0);
-		const auto c2 = v0 - static_cast<T>(2.5) * v1 + static_cast<T>(2.) * v2 - static_cast<T>(.5) * v3;
-		const auto c3 = static_cast<T>(1.5) * (v1 - v2) + static_cast<T>(.5) * (v3 - v0);
+	template<typename T>
+	T bSpline(const T* buffer, T readHead, int size) noexcept
+	{
+		const auto iFloor = std::floor(readHead);
+		auto i1 = static_cast<int>(iFloor);
+		auto i0 = i1 - 1;
+		auto i2 = i1 + 1;
+		auto i3 = i1 + 2;
+		if (i3 >= size) i3 -= size;
+		if (i2 >= size) i2 -= size;
+		if (i0 < 0) i0 += size;
 
-		return ((c3 * t + c2) * t + c1) * t + c0;
+		const auto t = readHead - iFloor;
+		return kernel::bSpline(buffer[i0], buffer[i1], buffer[i2], buffer[i3], t);
+	}
+
+	template<typename T>
+	T bSpline(const T* buffer, T readHead) noexcept
+	{
+		const auto iFloor = std::floor(readHead);
+		const auto i0 = static_cast<int>(iFloor);
+
+		const auto t = readHead - iFloor;
+		return kernel::bSpline(buffer[i0], buffer[i0 + 1], buffer[i0 + 2], buffer[i0 + 3], t);
 	}
 
 	template float lerp<float>(const float*, float, int) noexcept;
@@ -89,49 +119,342 @@ namespace interpolate
 	template double cubicHermiteSpline<double>(const double* samples, double idx, int size) noexcept;
 	template float cubicHermiteSpline<float>(const float* samples, float idx) noexcept;
 	template double cubicHermiteSpline<double>(const double* samples, double idx) noexcept;
+	template float lagrange4<float>(const float* samples, float idx, int size) noexcept;
+	template double lagrange4<double>(const double* samples, double idx, int size) noexcept;
+	template float lagrange4<float>(const float* samples, float idx) noexcept;
+	template double lagrange4<double>(const double* samples, double idx) noexcept;
+	template float bSpline<float>(const float* samples, float idx, int size) noexcept;
+	template double bSpline<double>(const double* samples, double idx, int size) noexcept;
+	template float bSpline<float>(const float* samples, float idx) noexcept;
+	template double bSpline<double>(const double* samples, double idx) noexcept;
 
 	///
 
-	namespace polynomial
+	namespace block
 	{
-		template<typename Float>
-		std::function<Float(Float)> getFunc(const std::vector<juce::Point<Float>>& points)
+		static constexpr int ChunkSize = 64;
+
+		/* dest, samples, idx, numSamples, kernel
+		reads samples[i0 .. i0 + 3] like the scalar functions without size */
+		template<typename T, typename Kernel>
+		inline void process4(T* dest, const T* samples, const T* idx, int numSamples, Kernel&& krnl) noexcept
 		{
-			return [&pts = points](Float xp)
+			int i0[ChunkSize];
+			T t[ChunkSize], v0[ChunkSize], v1[ChunkSize], v2[ChunkSize], v3[ChunkSize];
+
+			for (auto start = 0; start < numSamples; start += ChunkSize)
+			{
+				const auto n = std::min(ChunkSize, numSamples - start);
+				const auto idxChunk = idx + start;
+				auto destChunk = dest + start;
+
+				for (auto s = 0; s < n; ++s)
+				{
+					const auto iFloor = std::floor(idxChunk[s]);
+					i0[s] = static_cast<int>(iFloor);
+					t[s] = idxChunk[s] - iFloor;
+				}
+
+				for (auto s = 0; s < n; ++s)
+				{
+					const auto i = i0[s];
+					v0[s] = samples[i];
+					v1[s] = samples[i + 1];
+					v2[s] = samples[i + 2];
+					v3[s] = samples[i + 3];
+				}
+
+				for (auto s = 0; s < n; ++s)
+					destChunk[s] = krnl(v0[s], v1[s], v2[s], v3[s], t[s]);
+			}
+		}
+
+		/* dest, samples, idx, size, numSamples, kernel
+		reads around the wrapping read head like the scalar functions with size */
+		template<typename T, typename Kernel>
+		inline void process4(T* dest, const T* samples, const T* idx, int size, int numSamples, Kernel&& krnl) noexcept
+		{
+			int i1[ChunkSize];
+			T t[ChunkSize], v0[ChunkSize], v1[ChunkSize], v2[ChunkSize], v3[ChunkSize];
+
+			for (auto start = 0; start < numSamples; start += ChunkSize)
 			{
-				const auto n = pts.size();
-				auto yp = static_cast<Float>(0);
+				const auto n = std::min(ChunkSize, numSamples - start);
+				const auto idxChunk = idx + start;
+				auto destChunk = dest + start;
 
+				for (auto s = 0; s < n; ++s)
 				{
-					auto p = static_cast<Float>(1);
+					const auto iFloor = std::floor(idxChunk[s]);
+					i1[s] = static_cast<int>(iFloor);
+					t[s] = idxChunk[s] - iFloor;
+				}
+
+				for (auto s = 0; s < n; ++s)
+				{
+					const auto i = i1[s];
+					auto i0 = i - 1;
+					auto i2 = i + 1;
+					auto i3 = i + 2;
+					if (i3 >= size) i3 -= size;
+					if (i2 >= size) i2 -= size;
+					if (i0 < 0) i0 += size;
+					v0[s] = samples[i0];
+					v1[s] = samples[i];
+					v2[s] = samples[i2];
+					v3[s] = samples[i3];
+				}
+
+				for (auto s = 0; s < n; ++s)
+					destChunk[s] = krnl(v0[s], v1[s], v2[s], v3[s], t[s]);
+			}
+		}
+
+		template<typename T>
+		void lerp(T* dest, const T* samples, const T* idx, int numSamples) noexcept
+		{
+			int iF[ChunkSize];
+			T x[ChunkSize], a[ChunkSize], b[ChunkSize];
+
+			for (auto start = 0; start < numSamples; start += ChunkSize)
+			{
+				const auto n = std::min(ChunkSize, numSamples - start);
+				const auto idxChunk = idx + start;
+				auto destChunk = dest + start;
+
+				for (auto s = 0; s < n; ++s)
+				{
+					const auto iFloor = std::floor(idxChunk[s]);
+					iF[s] = static_cast<int>(iFloor);
+					x[s] = idxChunk[s] - iFloor;
+				}
+
+				for (auto s = 0; s < n; ++s)
+				{
+					a[s] = samples[iF[s]];
+					b[s] = samples[iF[s] + 1];
+				}
+
+				for (auto s = 0; s < n; ++s)
+					destChunk[s] = a[s] + x[s] * (b[s] - a[s]);
+			}
+		}
 
-					for (auto j = 1; j < n; ++j)
-					{
-						const auto denom = pts[0].x - pts[j].x;
-						if (denom != 0.f)
-							p *= (xp - pts[j].x) / denom;
-					}
+		template<typename T>
+		void lerp(T* dest, const T* samples, const T* idx, int size, int numSamples) noexcept
+		{
+			int iF[ChunkSize];
+			T x[ChunkSize], a[ChunkSize], b[ChunkSize];
+
+			for (auto start = 0; start < numSamples; start += ChunkSize)
+			{
+				const auto n = std::min(ChunkSize, numSamples - start);
+				const auto idxChunk = idx + start;
+				auto destChunk = dest + start;
 
-					yp += p * pts[0].y;
+				for (auto s = 0; s < n; ++s)
+				{
+					const auto iFloor = std::floor(idxChunk[s]);
+					iF[s] = static_cast<int>(iFloor);
+					x[s] = idxChunk[s] - iFloor;
 				}
 
-				for (auto i = 1; i < n; ++i)
+				for (auto s = 0; s < n; ++s)
 				{
-					auto p = static_cast<Float>(1);
+					const auto iC = iF[s] + 1;
+					a[s] = samples[iF[s]];
+					b[s] = iC != size ? samples[iC] : samples[0];
+				}
+
+				for (auto s = 0; s < n; ++s)
+					destChunk[s] = a[s] + x[s] * (b[s] - a[s]);
+			}
+		}
+
+		template<typename T>
+		void cubicHermiteSpline(T* dest, const T* samples, const T* idx, int numSamples) noexcept
+		{
+			process4(dest, samples, idx, numSamples, kernel::cubicHermiteSpline<T>);
+		}
+
+		template<typename T>
+		void cubicHermiteSpline(T* dest, const T* samples, const T* idx, int size, int numSamples) noexcept
+		{
+			process4(dest, samples, idx, size, numSamples, kernel::cubicHermiteSpline<T>);
+		}
+
+		template<typename T>
+		void lagrange4(T* dest, const T* samples, const T* idx, int numSamples) noexcept
+		{
+			process4(dest, samples, idx, numSamples, kernel::lagrange4<T>);
+		}
+
+		template<typename T>
+		void lagrange4(T* dest, const T* samples, const T* idx, int size, int numSamples) noexcept
+		{
+			process4(dest, samples, idx, size, numSamples, kernel::lagrange4<T>);
+		}
 
-					for (auto j = 0; j < n; ++j)
-						if (i != j)
-						{
-							const auto denom = pts[i].x - pts[j].x;
-							if (denom != 0.f)
-								p *= (xp - pts[j].x) / denom;
-						}
+		template<typename T>
+		void bSpline(T* dest, const T* samples, const T* idx, int numSamples) noexcept
+		{
+			process4(dest, samples, idx, numSamples, kernel::bSpline<T>);
+		}
+
+		template<typename T>
+		void bSpline(T* dest, const T* samples, const T* idx, int size, int numSamples) noexcept
+		{
+			process4(dest, samples, idx, size, numSamples, kernel::bSpline<T>);
+		}
 
+		template void lerp<float>(float*, const float*, const float*, int) noexcept;
+		template void lerp<double>(double*, const double*, const double*, int) noexcept;
+		template void lerp<float>(float*, const float*, const float*, int, int) noexcept;
+		template void lerp<double>(double*, const double*, const double*, int, int) noexcept;
+		template void cubicHermiteSpline<float>(float*, const float*, const float*, int) noexcept;
+		template void cubicHermiteSpline<double>(double*, const double*, const double*, int) noexcept;
+		template void cubicHermiteSpline<float>(float*, const float*, const float*, int, int) noexcept;
+		template void cubicHermiteSpline<double>(double*, const double*, const double*, int, int) noexcept;
+		template void lagrange4<float>(float*, const float*, const float*, int) noexcept;
+		template void lagrange4<double>(double*, const double*, const double*, int) noexcept;
+		template void lagrange4<float>(float*, const float*, const float*, int, int) noexcept;
+		template void lagrange4<double>(double*, const double*, const double*, int, int) noexcept;
+		template void bSpline<float>(float*, const float*, const float*, int) noexcept;
+		template void bSpline<double>(double*, const double*, const double*, int) noexcept;
+		template void bSpline<float>(float*, const float*, const float*, int, int) noexcept;
+		template void bSpline<double>(double*, const double*, const double*, int, int) noexcept;
+	}
+
+	// Sinc
+
+	template<typename T>
+	Sinc<T>::Sinc() :
+		table((NumPhases + 1) * NumTaps, static_cast<T>(0))
+	{
+		const auto pi = static_cast<T>(3.14159265358979);
+		const auto tau = pi * static_cast<T>(2);
+		const auto numTapsInv = static_cast<T>(1) / static_cast<T>(NumTaps);
 
-					yp += p * pts[i].y;
+		for (auto p = 0; p <= NumPhases; ++p)
+		{
+			const auto frac = static_cast<T>(p) / static_cast<T>(NumPhases);
+			auto row = table.data() + p * NumTaps;
+
+			for (auto k = 0; k < NumTaps; ++k)
+			{
+				// distance of the tap to the read position
+				const auto x = static_cast<T>(k - NumZeros + 1) - frac;
+				const auto sinc = x == static_cast<T>(0) ? static_cast<T>(1) : std::sin(pi * x) / (pi * x);
+				const auto w = (static_cast<T>(k) + static_cast<T>(1) - frac) * numTapsInv;
+				const auto window = static_cast<T>(.42) - static_cast<T>(.5) * std::cos(tau * w) + static_cast<T>(.08) * std::cos(static_cast<T>(2) * tau * w);
+				row[k] = sinc * window;
+			}
+		}
+	}
+
+	template<typename T>
+	T Sinc<T>::operator()(const T* samples, T idx, int size) const noexcept
+	{
+		const auto iFloor = std::floor(idx);
+		const auto iF = static_cast<int>(iFloor);
+		const auto phase = (idx - iFloor) * static_cast<T>(NumPhases);
+		const auto phaseFloor = std::floor(phase);
+		const auto pIdx = static_cast<int>(phaseFloor);
+		const auto pFrac = phase - phaseFloor;
+
+		const auto rowA = table.data() + pIdx * NumTaps;
+		const auto rowB = rowA + NumTaps;
+
+		auto y = static_cast<T>(0);
+		for (auto k = 0; k < NumTaps; ++k)
+		{
+			auto i = iF - NumZeros + 1 + k;
+			if (i < 0) i += size;
+			else if (i >= size) i -= size;
+			const auto coef = rowA[k] + pFrac * (rowB[k] - rowA[k]);
+			y += samples[i] * coef;
+		}
+		return y;
+	}
+
+	template<typename T>
+	void Sinc<T>::operator()(T* dest, const T* samples, const T* idx, int size, int numSamples) const noexcept
+	{
+		for (auto s = 0; s < numSamples; ++s)
+			dest[s] = operator()(samples, idx[s], size);
+	}
+
+	template struct Sinc<float>;
+	template struct Sinc<double>;
+
+	///
+
+	namespace polynomial
+	{
+		template<typename Float>
+		Lagrange<Float>::Lagrange(const std::vector<Point>& points) :
+			xs(),
+			ys(),
+			weights()
+		{
+			xs.reserve(points.size());
+			ys.reserve(points.size());
+			for (const auto& pt : points)
+				if (std::find(xs.begin(), xs.end(), pt.x) == xs.end())
+				{
+					xs.push_back(pt.x);
+					ys.push_back(pt.y);
 				}
 
-				return yp;
+			const auto n = xs.size();
+			weights.resize(n);
+			for (auto i = 0; i < n; ++i)
+			{
+				auto w = static_cast<Float>(1);
+				for (auto j = 0; j < n; ++j)
+					if (i != j)
+						w *= xs[i] - xs[j];
+				weights[i] = static_cast<Float>(1) / w;
+			}
+		}
+
+		template<typename Float>
+		Float Lagrange<Float>::operator()(Float x) const noexcept
+		{
+			const auto n = xs.size();
+			if (n == 0)
+				return static_cast<Float>(0);
+
+			auto num = static_cast<Float>(0);
+			auto denom = static_cast<Float>(0);
+			for (auto i = 0; i < n; ++i)
+			{
+				const auto dist = x - xs[i];
+				if (dist == static_cast<Float>(0))
+					return ys[i];
+				const auto t = weights[i] / dist;
+				num += t * ys[i];
+				denom += t;
+			}
+			return num / denom;
+		}
+
+		template<typename Float>
+		void Lagrange<Float>::operator()(Float* dest, const Float* x, int numSamples) const noexcept
+		{
+			for (auto s = 0; s < numSamples; ++s)
+				dest[s] = operator()(x[s]);
+		}
+
+		template struct Lagrange<float>;
+		template struct Lagrange<double>;
+
+		template<typename Float>
+		std::function<Float(Float)> getFunc(const std::vector<juce::Point<Float>>& points)
+		{
+			return [poly = Lagrange<Float>(points)](Float x)
+			{
+				return poly(x);
 			};
 		}
 
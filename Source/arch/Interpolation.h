@@ -31,10 +31,148 @@ namespace interpolate
 	template<typename T>
 	T cubicHermiteSpline(const T*, T) noexcept;
 
+	/* samples, idx, size */
+	template<typename T>
+	T lagrange4(const T*, T, int) noexcept;
+
+	/* samples, idx */
+	template<typename T>
+	T lagrange4(const T*, T) noexcept;
+
+	/* samples, idx, size */
+	template<typename T>
+	T bSpline(const T*, T, int) noexcept;
+
+	/* samples, idx */
+	template<typename T>
+	T bSpline(const T*, T) noexcept;
+
+	// the 4-point kernels, evaluated between v1 and v2
+	namespace kernel
+	{
+		/* v0, v1, v2, v3, t */
+		template<typename T>
+		inline T cubicHermiteSpline(T v0, T v1, T v2, T v3, T t) noexcept
+		{
+			const auto c0 = v1;
+			const auto c1 = static_cast<T>(.5) * (v2 - v0);
+			const auto c2 = v0 - static_cast<T>(2.5) * v1 + static_cast<T>(2.) * v2 - static_cast<T>(.5) * v3;
+			const auto c3 = static_cast<T>(1.5) * (v1 - v2) + static_cast<T>(.5) * (v3 - v0);
+
+			return ((c3 * t + c2) * t + c1) * t + c0;
+		}
+
+		/* v0, v1, v2, v3, t */
+		template<typename T>
+		inline T lagrange4(T v0, T v1, T v2, T v3, T t) noexcept
+		{
+			const auto c0 = v1;
+			const auto c1 = v2 - v0 * static_cast<T>(1. / 3.) - v1 * static_cast<T>(.5) - v3 * static_cast<T>(1. / 6.);
+			const auto c2 = static_cast<T>(.5) * (v0 + v2) - v1;
+			const auto c3 = static_cast<T>(1. / 6.) * (v3 - v0) + static_cast<T>(.5) * (v1 - v2);
+
+			return ((c3 * t + c2) * t + c1) * t + c0;
+		}
+
+		/* v0, v1, v2, v3, t
+		approximating, so it smoothes the signal instead of passing through the samples */
+		template<typename T>
+		inline T bSpline(T v0, T v1, T v2, T v3, T t) noexcept
+		{
+			const auto c0 = static_cast<T>(1. / 6.) * (v0 + v2) + static_cast<T>(2. / 3.) * v1;
+			const auto c1 = static_cast<T>(.5) * (v2 - v0);
+			const auto c2 = static_cast<T>(.5) * (v0 + v2) - v1;
+			const auto c3 = static_cast<T>(.5) * (v1 - v2) + static_cast<T>(1. / 6.) * (v3 - v0);
+
+			return ((c3 * t + c2) * t + c1) * t + c0;
+		}
+	}
+
+	// block variants, one read position per sample.
+	// the read indexes of a chunk are resolved first, so that the reads become gathers
+	// and the kernels run vectorized. dest may be the same buffer as idx.
+	namespace block
+	{
+		/* dest, samples, idx, numSamples */
+		template<typename T>
+		void lerp(T*, const T*, const T*, int) noexcept;
+
+		/* dest, samples, idx, size, numSamples */
+		template<typename T>
+		void lerp(T*, const T*, const T*, int, int) noexcept;
+
+		/* dest, samples, idx, numSamples */
+		template<typename T>
+		void cubicHermiteSpline(T*, const T*, const T*, int) noexcept;
+
+		/* dest, samples, idx, size, numSamples */
+		template<typename T>
+		void cubicHermiteSpline(T*, const T*, const T*, int, int) noexcept;
+
+		/* dest, samples, idx, numSamples */
+		template<typename T>
+		void lagrange4(T*, const T*, const T*, int) noexcept;
+
+		/* dest, samples, idx, size, numSamples */
+		template<typename T>
+		void lagrange4(T*, const T*, const T*, int, int) noexcept;
+
+		/* dest, samples, idx, numSamples */
+		template<typename T>
+		void bSpline(T*, const T*, const T*, int) noexcept;
+
+		/* dest, samples, idx, size, numSamples */
+		template<typename T>
+		void bSpline(T*, const T*, const T*, int, int) noexcept;
+	}
+
+	// windowed sinc (blackman) with a polyphase table, for wrapping buffers.
+	template<typename T>
+	struct Sinc
+	{
+		static constexpr int NumZeros = 8;
+		static constexpr int NumTaps = NumZeros * 2;
+		static constexpr int NumPhases = 256;
+
+		Sinc();
+
+		/* samples, idx, size */
+		T operator()(const T*, T, int) const noexcept;
+
+		/* dest, samples, idx, size, numSamples */
+		void operator()(T*, const T*, const T*, int, int) const noexcept;
+
+	protected:
+		// NumPhases + 1 rows of NumTaps coefficients
+		std::vector<T> table;
+	};
+
 	///
 
 	namespace polynomial
 	{
+		// the lagrange polynomial through a set of points, in barycentric form.
+		// the weights are computed once, so an evaluation is O(n).
+		// points with the same x as an earlier point are ignored.
+		template<typename Float>
+		struct Lagrange
+		{
+			using Point = juce::Point<Float>;
+
+			/* points */
+			Lagrange(const std::vector<Point>&);
+
+			/* x */
+			Float operator()(Float) const noexcept;
+
+			/* dest, x, numSamples. dest may be x */
+			void operator()(Float*, const Float*, int) const noexcept;
+
+		protected:
+			std::vector<Float> xs, ys, weights;
+		};
+
+		/* points. the function owns a copy of the polynomial */
 		template<typename Float>
 		std::function<Float(Float)> getFunc(const std::vector<juce::Point<Float>>&);
 	}
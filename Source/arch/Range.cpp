@@ -1,8 +1,49 @@
 #include "Range.h"
 #include "Conversion.h"
+#include <juce_audio_basics/juce_audio_basics.h>
 
 namespace makeRange
 {
+	using SIMD = juce::FloatVectorOperations;
+
+	/* table, minDenominator, maxDenominator, withZero, returns normValsY */
+	float makeBeatsTable(std::vector<float>& table, float minDenominator, float maxDenominator, bool withZero)
+	{
+		const auto minV = std::log2(minDenominator);
+		const auto maxV = std::log2(maxDenominator);
+		
+		const auto numWholeBeatsF = static_cast<float>(minV - maxV);
+		const auto numWholeBeatsInv = 1.f / numWholeBeatsF;
+		
+		const auto numWholeBeats = static_cast<int>(numWholeBeatsF);
+		const auto numValues = numWholeBeats * 3 + 1 + (withZero ? 1 : 0);
+		table.reserve(numValues);
+		if(withZero)
+			table.emplace_back(0.f);
+		
+		for (auto i = 0; i < numWholeBeats; ++i)
+		{
+			const auto iF = static_cast<float>(i);
+			const auto x = iF * numWholeBeatsInv;
+
+			const auto curV = minV - x * numWholeBeatsF;
+			const auto baseVal = std::pow(2.f, curV);
+			
+			const auto valWhole = 1.f / baseVal;
+			const auto valTriplet = valWhole * 1.666666666667f;
+			const auto valDotted = valWhole * 1.75f;
+			
+			table.emplace_back(valWhole);
+			table.emplace_back(valTriplet);
+			table.emplace_back(valDotted);
+		}
+		table.emplace_back(1.f / maxDenominator);
+
+		static constexpr float Eps = 1.f - std::numeric_limits<float>::epsilon();
+
+		return static_cast<float>(numValues) * Eps;
+	}
+
 	Range biased(float start, float end, float bias) noexcept
 	{
 		// https://www.desmos.com/calculator/ps8q8gftcr
@@ -136,44 +177,14 @@ namespace makeRange
 	Range beats(float minDenominator, float maxDenominator, bool withZero)
 	{
 		std::vector<float> table;
-		
-		const auto minV = std::log2(minDenominator);
-		const auto maxV = std::log2(maxDenominator);
-		
-		const auto numWholeBeatsF = static_cast<float>(minV - maxV);
-		const auto numWholeBeatsInv = 1.f / numWholeBeatsF;
-		
-		const auto numWholeBeats = static_cast<int>(numWholeBeatsF);
-		const auto numValues = numWholeBeats * 3 + 1 + (withZero ? 1 : 0);
-		table.reserve(numValues);
-		if(withZero)
-			table.emplace_back(0.f);
-		
-		for (auto i = 0; i < numWholeBeats; ++i)
-		{
-			const auto iF = static_cast<float>(i);
-			const auto x = iF * numWholeBeatsInv;
-
-			const auto curV = minV - x * numWholeBeatsF;
-			const auto baseVal = std::pow(2.f, curV);
-			
-			const auto valWhole = 1.f / baseVal;
-			const auto valTriplet = valWhole * 1.666666666667f;
-			const auto valDotted = valWhole * 1.75f;
-			
-			table.emplace_back(valWhole);
-			table.emplace_back(valTriplet);
-			table.emplace_back(valDotted);
-		}
-		table.emplace_back(1.f / maxDenominator);
+		const auto normValsY = makeBeatsTable(table, minDenominator, maxDenominator, withZero);
 
 		static constexpr float Eps = 1.f - std::numeric_limits<float>::epsilon();
 		static constexpr float EpsInv = 1.f / Eps;
 		
-		const auto numValuesF = static_cast<float>(numValues);
+		const auto numValuesF = static_cast<float>(table.size());
 		const auto numValuesInv = 1.f / numValuesF;
 		const auto numValsX = numValuesInv * EpsInv;
-		const auto normValsY = numValuesF * Eps;
 
 		Range range
 		{
@@ -205,4 +216,183 @@ namespace makeRange
 		
 		return range;
 	}
-}
\ No newline at end of file
+
+	// KERNEL
+
+	Kernel::Kernel() noexcept :
+		range(nullptr),
+		table(),
+		start(0.f),
+		end(1.f),
+		rangeLen(1.f),
+		a2(1.f),
+		aM(.5f),
+		aR(.5f),
+		tableScale(0.f),
+		numSteps(0),
+		type(Type::Lin)
+	{
+	}
+
+	Kernel::Kernel(const Range& r) noexcept :
+		range(&r),
+		table(),
+		start(r.start),
+		end(r.end),
+		rangeLen(r.end - r.start),
+		a2(1.f),
+		aM(.5f),
+		aR(.5f),
+		tableScale(0.f),
+		numSteps(0),
+		type(Type::Generic)
+	{
+	}
+
+	void Kernel::operator()(float* buffer, int numSamples) const noexcept
+	{
+		operator()(buffer, buffer, numSamples);
+	}
+
+	void Kernel::operator()(float* dest, const float* src, int numSamples) const noexcept
+	{
+		// convertFrom0to1 clamps the proportion before converting it as well
+		SIMD::clip(dest, src, 0.f, 1.f, numSamples);
+
+		switch (type)
+		{
+		case Type::Lin:
+			SIMD::multiply(dest, rangeLen, numSamples);
+			SIMD::add(dest, start, numSamples);
+			return;
+		case Type::Quad:
+			for (auto i = 0; i < numSteps; ++i)
+				SIMD::multiply(dest, dest, numSamples);
+			SIMD::multiply(dest, rangeLen, numSamples);
+			SIMD::add(dest, start, numSamples);
+			return;
+		case Type::Biased:
+			for (auto s = 0; s < numSamples; ++s)
+			{
+				const auto x = dest[s];
+				const auto denom = aM - x + a2 * x;
+				const auto y = start + aR * x / denom;
+				dest[s] = denom == 0.f ? start : y;
+			}
+			return;
+		case Type::Log:
+			for (auto s = 0; s < numSamples; ++s)
+				dest[s] = start + (std::pow(2.f, dest[s] * 10.f) - 1.f) * rangeLen / 1023.f;
+			return;
+		case Type::Table:
+			for (auto s = 0; s < numSamples; ++s)
+				dest[s] = table[static_cast<int>(dest[s] * tableScale)];
+			return;
+		default:
+			for (auto s = 0; s < numSamples; ++s)
+				dest[s] = range->convertFrom0to1(dest[s]);
+			return;
+		}
+	}
+
+	namespace kernel
+	{
+		Kernel biased(float start, float end, float bias) noexcept
+		{
+			if (bias == 0.f)
+				return lin(start, end);
+
+			const auto a = bias * .5f + .5f;
+
+			Kernel k;
+			k.start = start;
+			k.end = end;
+			k.rangeLen = end - start;
+			k.a2 = 2.f * a;
+			k.aM = 1.f - a;
+			k.aR = k.rangeLen * a;
+			k.type = Kernel::Type::Biased;
+			return k;
+		}
+
+		Kernel lin(float start, float end) noexcept
+		{
+			Kernel k;
+			k.start = start;
+			k.end = end;
+			k.rangeLen = end - start;
+			return k;
+		}
+
+		Kernel withCentre(float start, float end, float centre) noexcept
+		{
+			const auto r = end - start;
+			const auto v = (centre - start) / r;
+
+			return biased(start, end, 2.f * v - 1.f);
+		}
+
+		Kernel foleysLogRange(float min, float max) noexcept
+		{
+			auto k = lin(min, max);
+			k.type = Kernel::Type::Log;
+			return k;
+		}
+
+		Kernel quad(float min, float max, int numSteps) noexcept
+		{
+			auto k = lin(min, max);
+			k.numSteps = numSteps;
+			k.type = Kernel::Type::Quad;
+			return k;
+		}
+
+		Kernel beats(float minDenominator, float maxDenominator, bool withZero)
+		{
+			Kernel k;
+			k.tableScale = makeBeatsTable(k.table, minDenominator, maxDenominator, withZero);
+			k.start = k.table.front();
+			k.end = k.table.back();
+			k.rangeLen = k.end - k.start;
+			k.type = Kernel::Type::Table;
+			return k;
+		}
+	}
+
+	namespace ranged
+	{
+		Ranged biased(float start, float end, float bias) noexcept
+		{
+			return { makeRange::biased(start, end, bias), kernel::biased(start, end, bias) };
+		}
+
+		Ranged lin(float start, float end) noexcept
+		{
+			return { makeRange::lin(start, end), kernel::lin(start, end) };
+		}
+
+		Ranged withCentre(float start, float end, float centre) noexcept
+		{
+			return { makeRange::withCentre(start, end, centre), kernel::withCentre(start, end, centre) };
+		}
+
+		Ranged foleysLogRange(float min, float max) noexcept
+		{
+			return { makeRange::foleysLogRange(min, max), kernel::foleysLogRange(min, max) };
+		}
+
+		Ranged quad(float min, float max, int numSteps) noexcept
+		{
+			return { makeRange::quad(min, max, numSteps), kernel::quad(min, max, numSteps) };
+		}
+
+		Ranged beats(float minDenominator, float maxDenominator, bool withZero)
+		{
+			return
+			{
+				makeRange::beats(minDenominator, maxDenominator, withZero),
+				kernel::beats(minDenominator, maxDenominator, withZero)
+			};
+		}
+	}
+}
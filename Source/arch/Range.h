@@ -1,5 +1,6 @@
 #pragma once
 #include "juce_core/juce_core.h"
+#include <vector>
 
 namespace makeRange
 {
@@ -31,4 +32,87 @@ namespace makeRange
 	starts at 0, then 1/16 and ends at 2/1
 	*/
 	Range beats(float, float, bool = false);
+
+	// denormalises whole buffers at once with precomputed constants.
+	// gives the same results as convertFrom0to1 of the corresponding range.
+	struct Kernel
+	{
+		enum class Type
+		{
+			Generic,
+			Lin,
+			Biased,
+			Quad,
+			Log,
+			Table,
+			NumTypes
+		};
+
+		// lin [0, 1]
+		Kernel() noexcept;
+
+		// falls back to the range's own conversion
+		Kernel(const Range&) noexcept;
+
+		/* buffer, numSamples */
+		void operator()(float*, int) const noexcept;
+
+		/* dest, src, numSamples */
+		void operator()(float*, const float*, int) const noexcept;
+
+		const Range* range;
+		std::vector<float> table;
+		float start, end, rangeLen, a2, aM, aR, tableScale;
+		int numSteps;
+		Type type;
+	};
+
+	namespace kernel
+	{
+		/* start, end, bias[-1, 1] */
+		Kernel biased(float, float, float) noexcept;
+
+		/* start, end */
+		Kernel lin(float, float) noexcept;
+
+		/* start, end, centre */
+		Kernel withCentre(float, float, float) noexcept;
+
+		/* min, max */
+		Kernel foleysLogRange(float, float) noexcept;
+
+		/* min, max, numSteps ]1, N] */
+		Kernel quad(float, float, int) noexcept;
+
+		/* minDenominator, maxDenominator, withZero */
+		Kernel beats(float, float, bool = false);
+	}
+
+	// a range and its kernel, made from the same constants so they can't disagree
+	struct Ranged
+	{
+		Range range;
+		Kernel kernel;
+	};
+
+	namespace ranged
+	{
+		/* start, end, bias[-1, 1] */
+		Ranged biased(float, float, float) noexcept;
+
+		/* start, end */
+		Ranged lin(float, float) noexcept;
+
+		/* start, end, centre */
+		Ranged withCentre(float, float, float) noexcept;
+
+		/* min, max */
+		Ranged foleysLogRange(float, float) noexcept;
+
+		/* min, max, numSteps ]1, N] */
+		Ranged quad(float, float, int) noexcept;
+
+		/* minDenominator, maxDenominator, withZero */
+		Ranged beats(float, float, bool = false);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "Settings.h"
+
+sta::Settings::File::File(Settings& _settings, const Options& options) :
+	PropertiesFile(options),
+	settings(_settings)
+{
+}
+
+void sta::Settings::File::propertyChanged()
+{
+	// only marks the file dirty, see makeOptions
+	PropertiesFile::propertyChanged();
+	settings.lastChangeMs.store(juce::Time::getMillisecondCounter());
+}
+
+sta::Settings::Settings() :
+	juce::Thread("Settings"),
+	user(),
+	lastChangeMs(0)
+{
+	user = std::make_unique<File>(*this, makeOptions());
+	startThread();
+}
+
+sta::Settings::~Settings()
+{
+	// the thread flushes the last changes on its way out
+	stopThread(MaxDelayMs);
+}
+
+juce::PropertiesFile* sta::Settings::getUserSettings() noexcept
+{
+	return user.get();
+}
+
+void sta::Settings::run()
+{
+	auto dirtySinceMs = 0u;
+	while (!threadShouldExit())
+	{
+		wait(DebounceMs);
+		if (!user->needsToBeSaved())
+		{
+			dirtySinceMs = 0;
+			continue;
+		}
+
+		const auto now = juce::Time::getMillisecondCounter();
+		if (dirtySinceMs == 0)
+			dirtySinceMs = now;
+		const auto quiet = now - lastChangeMs.load() >= static_cast<juce::uint32>(DebounceMs);
+		const auto overdue = now - dirtySinceMs >= static_cast<juce::uint32>(MaxDelayMs);
+		if (quiet || overdue)
+		{
+			save();
+			dirtySinceMs = 0;
+		}
+	}
+	if (user->needsToBeSaved())
+		save();
+}
+
+void sta::Settings::save()
+{
+	std::unique_ptr<juce::XmlElement> xml;
+	{
+		const juce::ScopedLock lock(user->getLock());
+		// same layout as PropertiesFile::saveAsXml
+		xml = user->createXml("PROPERTIES");
+		user->setNeedsToBeSaved(false);
+	}
+
+	// writeTo goes through a TemporaryFile, so a failed write never leaves a truncated file
+	const auto file = user->getFile();
+	const auto saved = file.getParentDirectory().createDirectory()
+		&& xml->writeTo(file);
+	if (!saved)
+		user->setNeedsToBeSaved(true);
+}
+
+juce::PropertiesFile::Options sta::Settings::makeOptions()
+{
+	PropertiesFile::Options options;
+	options.applicationName = JucePlugin_Name;
+	options.filenameSuffix = ".settings";
+	options.folderName = "Mrugalla" + juce::File::getSeparatorString() + JucePlugin_Name;
+	options.osxLibrarySubFolder = "Application Support";
+	options.commonToAllUsers = false;
+	options.ignoreCaseOfKeyNames = false;
+	options.doNotSave = false;
+	// never saves by itself, the settings thread does
+	options.millisecondsBeforeSaving = -1;
+	options.storageFormat = PropertiesFile::storeAsXML;
+	return options;
+}
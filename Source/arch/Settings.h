@@ -0,0 +1,51 @@
+#pragma once
+#include <juce_data_structures/juce_data_structures.h>
+
+namespace sta
+{
+	/*
+	* the user settings file, shared by every instance of the plugin in the process.
+	* hold it with a juce::SharedResourcePointer, the last one to go flushes it.
+	* changed values only mark the file dirty. one background thread saves it once it
+	* has been quiet for DebounceMs (or dirty for MaxDelayMs), so no audio or message
+	* thread call waits for the disk.
+	*/
+	class Settings :
+		public juce::Thread
+	{
+		using PropertiesFile = juce::PropertiesFile;
+
+		struct File :
+			public PropertiesFile
+		{
+			/* settings, options */
+			File(Settings&, const Options&);
+
+			Settings& settings;
+		protected:
+			void propertyChanged() override;
+		};
+
+	public:
+		static constexpr int DebounceMs = 500;
+		static constexpr int MaxDelayMs = 5000;
+
+		Settings();
+
+		~Settings() override;
+
+		/* thread-safe */
+		PropertiesFile* getUserSettings() noexcept;
+
+		void run() override;
+
+	protected:
+		std::unique_ptr<File> user;
+		std::atomic<juce::uint32> lastChangeMs;
+
+		// copies the properties under their lock, but writes the file outside of it
+		void save();
+
+		static PropertiesFile::Options makeOptions();
+	};
+}
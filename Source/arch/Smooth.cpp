@@ -229,4 +229,147 @@ namespace smooth
 	
 	template struct Smooth<float>;
 	template struct Smooth<double>;
-}
\ No newline at end of file
+
+	// Bank
+
+	template<typename Float>
+	Bank<Float>::Bank() :
+		blockVal(),
+		y1(),
+		a0(),
+		b1(),
+		cur(),
+		dest(),
+		smoothing(),
+		data(),
+		buffers(nullptr),
+		numLanes(0),
+		stride(0)
+	{
+		a0.fill(static_cast<Float>(1));
+		smoothing.fill(false);
+	}
+
+	template<typename Float>
+	int Bank<Float>::addLane(Float startVal)
+	{
+		const auto lane = numLanes;
+		jassert(lane < MaxLanes);
+		blockVal[lane] = y1[lane] = cur[lane] = dest[lane] = startVal;
+		++numLanes;
+		return lane;
+	}
+
+	template<typename Float>
+	void Bank<Float>::prepare(int blockSize)
+	{
+		stride = (blockSize + AlignSamples - 1) / AlignSamples * AlignSamples;
+		data.resize(static_cast<size_t>(stride * numLanes + AlignSamples), static_cast<Float>(0));
+
+		const auto address = reinterpret_cast<size_t>(data.data());
+		const auto alignBytes = static_cast<size_t>(AlignSamples) * sizeof(Float);
+		const auto misalignment = address % alignBytes;
+		const auto offset = misalignment == 0 ? 0 : (alignBytes - misalignment) / sizeof(Float);
+		buffers = data.data() + offset;
+
+		for (auto l = 0; l < numLanes; ++l)
+		{
+			smoothing[l] = false;
+			cur[l] = blockVal[l] = y1[l] = dest[l];
+			SIMD::fill(buffers + l * stride, dest[l], stride);
+		}
+	}
+
+	template<typename Float>
+	void Bank<Float>::makeFromDecayInMs(int lane, Float smoothLenMs, Float Fs) noexcept
+	{
+		Lowpass<Float> lowpass;
+		lowpass.makeFromDecayInMs(smoothLenMs, Fs);
+		a0[lane] = lowpass.a0;
+		b1[lane] = lowpass.b1;
+	}
+
+	template<typename Float>
+	void Bank<Float>::setDest(int lane, Float val) noexcept
+	{
+		dest[lane] = val;
+	}
+
+	template<typename Float>
+	void Bank<Float>::operator()(int numSamples) noexcept
+	{
+		std::array<int, MaxLanes> idx;
+		auto numActive = 0;
+		for (auto l = 0; l < numLanes; ++l)
+			if (smoothing[l] || cur[l] != dest[l])
+				idx[numActive++] = l;
+		if (numActive == 0)
+			return;
+
+		std::array<Float, MaxLanes> x, inc, y, a, b;
+		const auto numSamplesInv = static_cast<Float>(1) / static_cast<Float>(numSamples);
+		for (auto i = 0; i < numActive; ++i)
+		{
+			const auto l = idx[i];
+			x[i] = blockVal[l];
+			inc[i] = (dest[l] - blockVal[l]) * numSamplesInv;
+			y[i] = y1[l];
+			a[i] = a0[l];
+			b[i] = b1[l];
+		}
+
+		for (auto s = 0; s < numSamples; ++s)
+		{
+			for (auto i = 0; i < numActive; ++i)
+			{
+				y[i] = x[i] * a[i] + y[i] * b[i];
+				x[i] += inc[i];
+			}
+			for (auto i = 0; i < numActive; ++i)
+				buffers[idx[i] * stride + s] = y[i];
+		}
+
+		for (auto i = 0; i < numActive; ++i)
+		{
+			const auto l = idx[i];
+			auto buf = buffers + l * stride;
+			const auto last = buf[numSamples - 1];
+
+			if (buf[0] == last)
+			{
+				// settled: snap to the destination and keep the buffer constant
+				smoothing[l] = false;
+				cur[l] = blockVal[l] = y1[l] = dest[l];
+				SIMD::fill(buf, dest[l], stride);
+			}
+			else
+			{
+				smoothing[l] = true;
+				cur[l] = last;
+				blockVal[l] = x[i];
+				y1[l] = y[i];
+			}
+		}
+	}
+
+	template<typename Float>
+	const Float* Bank<Float>::operator[](int lane) const noexcept
+	{
+		return buffers + lane * stride;
+	}
+
+	template<typename Float>
+	bool Bank<Float>::isSmoothing(int lane) const noexcept
+	{
+		return smoothing[lane];
+	}
+
+	template<typename Float>
+	Float Bank<Float>::getDest(int lane) const noexcept
+	{
+		return dest[lane];
+	}
+
+	template struct Bank<float>;
+	template struct Bank<double>;
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <array>
+#include <vector>
 
 namespace smooth
 {
@@ -87,4 +89,47 @@ namespace smooth
 		Float cur, dest;
 		bool smoothing;
 	};
+
+	// the smoothers of a processor, advanced together.
+	// states are stored per lane (SoA), so one sample step runs over all moving lanes at once.
+	// every lane owns a cache-line aligned buffer. settled lanes are skipped and keep a constant buffer.
+	template<typename Float>
+	struct Bank
+	{
+		static constexpr int MaxLanes = 16;
+		static constexpr int AlignSamples = 64 / static_cast<int>(sizeof(Float));
+
+		Bank();
+
+		/* startVal, returns the lane index. only add lanes before prepare */
+		int addLane(Float);
+
+		/* blockSize */
+		void prepare(int);
+
+		/* lane, smoothLenMs, Fs */
+		void makeFromDecayInMs(int, Float, Float) noexcept;
+
+		/* lane, dest */
+		void setDest(int, Float) noexcept;
+
+		/* numSamples */
+		void operator()(int) noexcept;
+
+		/* lane */
+		const Float* operator[](int) const noexcept;
+
+		/* lane */
+		bool isSmoothing(int) const noexcept;
+
+		/* lane */
+		Float getDest(int) const noexcept;
+
+	protected:
+		std::array<Float, MaxLanes> blockVal, y1, a0, b1, cur, dest;
+		std::array<bool, MaxLanes> smoothing;
+		std::vector<Float> data;
+		Float* buffers;
+		int numLanes, stride;
+	};
 }
\ No newline at end of file
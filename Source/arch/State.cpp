@@ -1,22 +1,63 @@
 #include "State.h"
 
+sta::StateKey::StateKey(const juce::String& key, const juce::String& _id) :
+	path(),
+	id(State::toID(_id))
+{
+	for (const auto& name : juce::StringArray::fromTokens(State::toID(key), "/", ""))
+		if (name.isNotEmpty())
+			path.emplace_back(name);
+}
+
 sta::State::State() :
 	state("state"),
-	undoer()
+	undoer(MaxUndoUnits, MinUndoTransactions),
+	fixedKeys(),
+	fixedIDs(),
+	fixedProps(),
+	fixedHash(0),
+	transactionDepth(0)
 {
 }
 
 sta::State::State(const String& str) :
 	state("state"),
-	undoer()
+	undoer(MaxUndoUnits, MinUndoTransactions),
+	fixedKeys(),
+	fixedIDs(),
+	fixedProps(),
+	fixedHash(0),
+	transactionDepth(0)
 {
 	state = state.fromXml(str);
 }
 
-void sta::State::savePatch(const Proc& p, juce::MemoryBlock& destData) const
+void sta::State::savePatch(const Proc&, juce::MemoryBlock& destData) const
 {
-	std::unique_ptr<juce::XmlElement> xml(state.createXml());
-	p.copyXmlToBinary(*xml, destData);
+	juce::MemoryOutputStream stream(destData, true);
+	stream.writeInt(Magic);
+	stream.writeInt(Version);
+	stream.writeInt(static_cast<int>(fixedKeys.size()));
+	stream.writeInt(static_cast<int>(fixedIDs.size()));
+	stream.writeInt64(fixedHash);
+
+	// one float per key and id at a fixed offset, nan if the property doesn't exist
+	for (const auto& prop : fixedProps)
+	{
+		const auto var = get(prop);
+		stream.writeFloat(var != nullptr ? static_cast<float>(*var) : std::numeric_limits<float>::quiet_NaN());
+	}
+
+	// the names are only read if the loading version has a different layout
+	juce::MemoryOutputStream names;
+	for (const auto& key : fixedKeys)
+		names.writeString(key);
+	for (const auto& id : fixedIDs)
+		names.writeString(id);
+	stream.writeInt(static_cast<int>(names.getDataSize()));
+	stream.write(names.getData(), names.getDataSize());
+
+	writeTree(stream, state, "");
 }
 
 void sta::State::savePatch(juce::File& xmlFile) const
@@ -37,7 +78,8 @@ void sta::State::loadPatch(const XML& xmlState)
 
 void sta::State::loadPatch(const Proc& p, const void* data, int sizeInBytes)
 {
-	loadPatch(p.getXmlFromBinary(data, sizeInBytes));
+	if (!loadBinary(data, sizeInBytes))
+		loadPatch(p.getXmlFromBinary(data, sizeInBytes));
 }
 
 void sta::State::loadPatch(const char* data, int sizeInBytes)
@@ -58,50 +100,28 @@ void sta::State::loadPatch(const juce::File& xmlFile)
 void sta::State::loadPatch(const ValueTree& vt)
 {
 	state = vt;
+	// the history refers to the previous tree
+	undoer.clearUndoHistory();
 }
 
 void sta::State::set(String&& key, String&& id, Var&& val, bool undoable)
 {
-	if (undoable)
-	{
-		undoer.beginNewTransaction();
-		setProperty(toID(key), toID(id), std::move(val), state, &undoer);
-	}
-	else
-		setProperty(toID(key), toID(id), std::move(val), state, nullptr);
+	setProperty(toID(key), toID(id), std::move(val), state, undoable);
 }
 
 void sta::State::set(String&& key, const String& id, Var&& val, bool undoable)
 {
-	if (undoable)
-	{
-		undoer.beginNewTransaction();
-		setProperty(toID(key), toID(id), std::move(val), state, &undoer);
-	}
-	else
-		setProperty(toID(key), toID(id), std::move(val), state, nullptr);
+	setProperty(toID(key), toID(id), std::move(val), state, undoable);
 }
 
 void sta::State::set(const String& key, String&& id, Var&& val, bool undoable)
 {
-	if (undoable)
-	{
-		undoer.beginNewTransaction();
-		setProperty(toID(key), toID(id), std::move(val), state, &undoer);
-	}
-	else
-		setProperty(toID(key), toID(id), std::move(val), state, nullptr);
+	setProperty(toID(key), toID(id), std::move(val), state, undoable);
 }
 
 void sta::State::set(const String& key, const String& id, Var&& val, bool undoable)
 {
-	if (undoable)
-	{
-		undoer.beginNewTransaction();
-		setProperty(toID(key), toID(id), std::move(val), state, &undoer);
-	}
-	else
-		setProperty(toID(key), toID(id), std::move(val), state, nullptr);
+	setProperty(toID(key), toID(id), std::move(val), state, undoable);
 }
 
 const sta::State::Var* sta::State::get(String&& key, String&& id) const
@@ -119,6 +139,116 @@ const sta::State::Var* sta::State::get(const String& key, const String& id) cons
 	return getProperty(key, toID(id), state);
 }
 
+void sta::State::set(const StateKey& key, Var&& val, bool undoable)
+{
+	auto knot = state;
+	for (const auto& name : key.path)
+	{
+		auto child = knot.getChildWithName(name);
+		if (!child.isValid())
+		{
+			child = ValueTree(name);
+			knot.appendChild(child, nullptr);
+		}
+		knot = child;
+	}
+	writeProperty(knot, key.id, std::move(val), undoable);
+}
+
+const sta::State::Var* sta::State::get(const StateKey& key) const
+{
+	auto knot = state;
+	for (const auto& name : key.path)
+	{
+		knot = knot.getChildWithName(name);
+		if (!knot.isValid())
+			return nullptr;
+	}
+	return knot.getPropertyPointer(key.id);
+}
+
+void sta::State::setFixedLayout(const std::vector<String>& keys, const std::vector<String>& ids)
+{
+	fixedKeys.clear();
+	fixedIDs.clear();
+	fixedProps.clear();
+	String layout;
+	for (const auto& key : keys)
+	{
+		fixedKeys.push_back(toID(key));
+		layout << fixedKeys.back() << ",";
+	}
+	for (const auto& id : ids)
+	{
+		fixedIDs.push_back(toID(id));
+		layout << fixedIDs.back() << ",";
+	}
+	fixedHash = layout.hashCode64();
+
+	fixedProps.reserve(fixedKeys.size() * fixedIDs.size());
+	for (const auto& key : fixedKeys)
+		for (const auto& id : fixedIDs)
+			fixedProps.emplace_back(key, id);
+}
+
+sta::State::Benchmark sta::State::benchmark(const Proc& p, int numRuns) const
+{
+	using Time = juce::Time;
+	juce::MemoryBlock bin, xml;
+	State loader;
+	loader.setFixedLayout(fixedKeys, fixedIDs);
+
+	auto start = Time::getMillisecondCounterHiRes();
+	for (auto i = 0; i < numRuns; ++i)
+	{
+		bin.reset();
+		savePatch(p, bin);
+	}
+	const auto binSaveMs = Time::getMillisecondCounterHiRes() - start;
+
+	start = Time::getMillisecondCounterHiRes();
+	for (auto i = 0; i < numRuns; ++i)
+		loader.loadPatch(p, bin.getData(), static_cast<int>(bin.getSize()));
+	const auto binLoadMs = Time::getMillisecondCounterHiRes() - start;
+
+	start = Time::getMillisecondCounterHiRes();
+	for (auto i = 0; i < numRuns; ++i)
+	{
+		xml.reset();
+		std::unique_ptr<juce::XmlElement> x(state.createXml());
+		p.copyXmlToBinary(*x, xml);
+	}
+	const auto xmlSaveMs = Time::getMillisecondCounterHiRes() - start;
+
+	start = Time::getMillisecondCounterHiRes();
+	for (auto i = 0; i < numRuns; ++i)
+		loader.loadPatch(p, xml.getData(), static_cast<int>(xml.getSize()));
+	const auto xmlLoadMs = Time::getMillisecondCounterHiRes() - start;
+
+	return
+	{
+		static_cast<int>(bin.getSize()), static_cast<int>(xml.getSize()),
+		binSaveMs, binLoadMs, xmlSaveMs, xmlLoadMs
+	};
+}
+
+void sta::State::beginTransaction()
+{
+	if (transactionDepth++ == 0)
+		undoer.beginNewTransaction();
+}
+
+void sta::State::endTransaction()
+{
+	jassert(transactionDepth > 0);
+	transactionDepth = std::max(0, transactionDepth - 1);
+}
+
+void sta::State::setUndoLimit(int maxUnits, int minTransactions)
+{
+	undoer.setMaxNumberOfStoredUnits(maxUnits, minTransactions);
+}
+
 void sta::State::undo()
 {
 	if (undoer.canUndo())
@@ -150,15 +280,15 @@ sta::State::String sta::State::toString(String&& key, String&& id) const
 		return var->toString();
 }
 
-sta::State::String sta::State::toID(const String& txt) const
+sta::State::String sta::State::toID(const String& txt)
 {
 	return txt.removeCharacters(" ").toLowerCase();
 }
 
-void sta::State::setProperty(const String& key, const String& id, Var&& val, ValueTree knot, Undo* mngr)
+void sta::State::setProperty(const String& key, const String& id, Var&& val, ValueTree knot, bool undoable)
 {
 	if (knot.getType().toString() == key)
-		knot.setProperty(id, val, mngr);
+		writeProperty(knot, id, std::move(val), undoable);
 	else if (!key.contains("/"))
 	{
 		auto child = knot.getChildWithName(key);
@@ -167,7 +297,7 @@ void sta::State::setProperty(const String& key, const String& id, Var&& val, Val
 			child = ValueTree(key);
 			knot.appendChild(child, nullptr);
 		}
-		setProperty(key, id, std::move(val), child, mngr);
+		setProperty(key, id, std::move(val), child, undoable);
 	}
 	else
 		for (auto i = 0; i < key.length(); ++i)
@@ -180,10 +310,28 @@ void sta::State::setProperty(const String& key, const String& id, Var&& val, Val
 					child = ValueTree(childName);
 					knot.appendChild(child, nullptr);
 				}
-				return setProperty(key.substring(i + 1), id, std::move(val), child, mngr);
+				return setProperty(key.substring(i + 1), id, std::move(val), child, undoable);
 			}
 }
 
+void sta::State::writeProperty(ValueTree& knot, const juce::Identifier& id, Var&& val, bool undoable)
+{
+	// unchanged values don't make it into the history
+	if (const auto current = knot.getPropertyPointer(id))
+		if (*current == val)
+			return;
+
+	if (!undoable)
+	{
+		knot.setProperty(id, std::move(val), nullptr);
+		return;
+	}
+	// within a transaction all writes join the step it opened
+	if (transactionDepth == 0)
+		undoer.beginNewTransaction();
+	knot.setProperty(id, std::move(val), &undoer);
+}
+
 const sta::State::Var* sta::State::getProperty(const String& key, const String& id, ValueTree knot) const
 {
 	if (key.contains("/"))
@@ -204,4 +352,100 @@ const sta::State::Var* sta::State::getProperty(const String& key, const String&
 	if (child.hasProperty(id))
 		return &child.getProperty(id);
 	return nullptr;
-}
\ No newline at end of file
+}
+
+bool sta::State::isFixed(const String& key, const String& id) const noexcept
+{
+	return std::find(fixedIDs.begin(), fixedIDs.end(), id) != fixedIDs.end()
+		&& std::find(fixedKeys.begin(), fixedKeys.end(), key) != fixedKeys.end();
+}
+
+void sta::State::writeTree(OutputStream& stream, const ValueTree& knot, const String& path) const
+{
+	// the layout of ValueTree::writeToStream, minus the fixed properties
+	stream.writeString(knot.getType().toString());
+
+	std::vector<juce::Identifier> props;
+	for (auto i = 0; i < knot.getNumProperties(); ++i)
+	{
+		const auto name = knot.getPropertyName(i);
+		if (!isFixed(path, name.toString()))
+			props.push_back(name);
+	}
+	stream.writeCompressedInt(static_cast<int>(props.size()));
+	for (const auto& name : props)
+	{
+		stream.writeString(name.toString());
+		knot.getProperty(name).writeToStream(stream);
+	}
+
+	// children that only held fixed properties are left out
+	std::vector<ValueTree> children;
+	for (const auto& child : knot)
+	{
+		const auto childPath = path.isEmpty() ? child.getType().toString() : path + "/" + child.getType().toString();
+		auto empty = child.getNumChildren() == 0;
+		for (auto i = 0; empty && i < child.getNumProperties(); ++i)
+			empty = isFixed(childPath, child.getPropertyName(i).toString());
+		if (!empty)
+			children.push_back(child);
+	}
+	stream.writeCompressedInt(static_cast<int>(children.size()));
+	for (const auto& child : children)
+		writeTree(stream, child, path.isEmpty() ? child.getType().toString() : path + "/" + child.getType().toString());
+}
+
+bool sta::State::loadBinary(const void* data, int sizeInBytes)
+{
+	static constexpr int HeaderSize = 24;
+	if (data == nullptr || sizeInBytes < HeaderSize)
+		return false;
+
+	juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+	if (stream.readInt() != Magic)
+		return false;
+	if (stream.readInt() > Version)
+		return false;
+	const auto numKeys = stream.readInt();
+	const auto numIDs = stream.readInt();
+	const auto hash = stream.readInt64();
+	if (numKeys < 0 || numIDs < 0 || HeaderSize + numKeys * numIDs * 4 > sizeInBytes)
+		return false;
+
+	std::vector<float> block(static_cast<size_t>(numKeys * numIDs));
+	for (auto& v : block)
+		v = stream.readFloat();
+
+	const auto namesSize = stream.readInt();
+	const auto sameLayout = hash == fixedHash
+		&& numKeys == static_cast<int>(fixedKeys.size())
+		&& numIDs == static_cast<int>(fixedIDs.size());
+	std::vector<StateKey> props;
+	if (sameLayout)
+		stream.skipNextBytes(namesSize);
+	else
+	{
+		std::vector<String> keys, ids;
+		for (auto k = 0; k < numKeys; ++k)
+			keys.push_back(stream.readString());
+		for (auto i = 0; i < numIDs; ++i)
+			ids.push_back(stream.readString());
+		props.reserve(block.size());
+		for (const auto& key : keys)
+			for (const auto& id : ids)
+				props.emplace_back(key, id);
+	}
+
+	auto tree = ValueTree::readFromStream(stream);
+	if (!tree.isValid())
+		return false;
+	state = tree;
+	undoer.clearUndoHistory();
+
+	const auto& layout = sameLayout ? fixedProps : props;
+	for (auto p = 0; p < static_cast<int>(block.size()); ++p)
+		if (!std::isnan(block[p]))
+			set(layout[p], block[p], false);
+
+	return true;
+}
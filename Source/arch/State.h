@@ -4,6 +4,19 @@
 
 namespace sta
 {
+	/*
+	* a key path and a property id of the state, interned into identifiers once.
+	* looking them up compares pointers instead of building and comparing strings.
+	*/
+	struct StateKey
+	{
+		/* key (e.g. "params/ratehz"), id */
+		StateKey(const juce::String&, const juce::String&);
+
+		std::vector<juce::Identifier> path;
+		juce::Identifier id;
+	};
+
 	class State
 	{
 		using String = juce::String;
@@ -13,18 +26,29 @@ namespace sta
 		using XML = std::unique_ptr<juce::XmlElement>;
 		using XMLDoc = juce::XmlDocument;
 		using Proc = juce::AudioProcessor;
+		using OutputStream = juce::OutputStream;
+		using InputStream = juce::InputStream;
 
 	public:
+		// binary patch format: header, fixed layout block, rest of the tree (juce's binary valuetree)
+		static constexpr int Magic = 0x534d4e50; // "PNMS"
+		static constexpr int Version = 1;
+		// undo history cap (roughly bytes) and the number of steps kept regardless
+		static constexpr int MaxUndoUnits = 1 << 16;
+		static constexpr int MinUndoTransactions = 16;
+
 		State();
 
 		State(const String&);
 
+		/* proc, destData. writes the binary format */
 		void savePatch(const Proc&, juce::MemoryBlock&) const;
 
 		void savePatch(juce::File&) const;
 
 		void loadPatch(const XML&);
 
+		/* proc, data, sizeInBytes. reads the binary format or the xml of older versions */
 		void loadPatch(const Proc&, const void* /*data*/ , int /*sizeInBytes*/);
 
 		void loadPatch(const char* /*data*/, int /*sizeInBytes*/);
@@ -54,6 +78,32 @@ namespace sta
 		/*key, id*/
 		const Var* get(const String& /*key*/, const String& /*id*/) const;
 
+		/*key, val, undoable*/
+		void set(const StateKey&, Var&&, bool /*undoable*/ = true);
+
+		/*key*/
+		const Var* get(const StateKey&) const;
+
+		/* keys, ids. the properties that are stored at fixed offsets of the binary format */
+		void setFixedLayout(const std::vector<String>&, const std::vector<String>&);
+
+		struct Benchmark
+		{
+			int binBytes, xmlBytes;
+			double binSaveMs, binLoadMs, xmlSaveMs, xmlLoadMs;
+		};
+
+		/* proc, numRuns. compares the binary format with the xml one, loading into a separate state */
+		Benchmark benchmark(const Proc&, int) const;
+
+		/* opens a transaction. undoable writes until the matching endTransaction become one undo step */
+		void beginTransaction();
+
+		void endTransaction();
+
+		/* maxUnits, minTransactions */
+		void setUndoLimit(int, int);
+
 		void undo();
 
 		void redo();
@@ -67,15 +117,34 @@ namespace sta
 
 		String toString(String&& /*key*/, String&& /*id*/) const;
 
+		/* txt, removes spaces and makes it lowercase */
+		static String toID(const String&);
+
 	protected:
 		ValueTree state;
 		Undo undoer;
+		std::vector<String> fixedKeys, fixedIDs;
+		// fixedKeys x fixedIDs, interned
+		std::vector<StateKey> fixedProps;
+		juce::int64 fixedHash;
+		int transactionDepth;
 
 	private:
-		String toID(const String& /*txt*/) const;
 
-		void setProperty(const String& /*key*/, const String& /*id*/, Var&&, ValueTree /*knot*/, Undo*);
+		void setProperty(const String& /*key*/, const String& /*id*/, Var&&, ValueTree /*knot*/, bool /*undoable*/);
+
+		/* knot, id, val, undoable. skips unchanged values */
+		void writeProperty(ValueTree&, const juce::Identifier&, Var&&, bool);
 
 		const Var* getProperty(const String& /*key*/, const String& /*id*/, ValueTree /*knot*/) const;
+
+		/* key, id */
+		bool isFixed(const String&, const String&) const noexcept;
+
+		/* stream, knot, path */
+		void writeTree(OutputStream&, const ValueTree&, const String&) const;
+
+		/* data, sizeInBytes, returns false if it's not the binary format */
+		bool loadBinary(const void*, int);
 	};
 }
\ No newline at end of file
@@ -20,6 +20,7 @@ namespace audio
     using PlayHeadPos = juce::AudioPlayHead::CurrentPositionInfo;
 
     using Smooth = smooth::Smooth<float>;
+    using SmoothBank = smooth::Bank<float>;
     using PID = param::PID;
     using Params = param::Params;
     using Param = param::Param;
@@ -61,13 +61,15 @@ namespace audio
 		readHeadBuffer(),
 		delay(),
 
-		feedbackP(0.f),
-		dampP(1.f),
-		retuneP(0.f),
+		prms(),
 
 		Fs(0.f), sizeF(0.f), curDelay(0.f), curNote(48.f),
 		size(0)
-	{}
+	{
+		prms.addLane(0.f);
+		prms.addLane(1.f);
+		prms.addLane(0.f);
+	}
 
 	void CombFilter::prepare(float sampleRate, int blockSize)
 	{
@@ -83,9 +85,9 @@ namespace audio
 		const auto freqHz = xenManager.noteToFreqHzWithWrap(curNote, LowestFrequencyHz);
 		curDelay = freqHzInSamples(freqHz, Fs);
 
-		feedbackP.prepare(sampleRate, blockSize, 10.f);
-		dampP.prepare(sampleRate, blockSize, 10.f);
-		retuneP.prepare(sampleRate, blockSize, 10.f);
+		prms.prepare(blockSize);
+		for (auto i = 0; i < NumPRMLanes; ++i)
+			prms.makeFromDecayInMs(i, 10.f, sampleRate);
 	}
 
 	void CombFilter::operator()(float* const* samples, int numChannels, int numSamples,
@@ -94,7 +96,12 @@ namespace audio
 		writeHead(numSamples);
 		const auto wHead = writeHead.data();
 
-		const auto retuneBuf = retuneP(_retune, numSamples);
+		prms.setDest(Feedback, _feedback);
+		prms.setDest(Damp, smooth::Lowpass<float>::getXFromHz(_damp, Fs));
+		prms.setDest(Retune, _retune);
+		prms(numSamples);
+
+		const auto retuneBuf = prms[Retune];
 
 		{ // calculate readhead indexes from note buffer
 			auto rHeadBuf = readHeadBuffer.getArrayOfWritePointers();
@@ -127,13 +134,9 @@ namespace audio
 				SIMD::copy(rHeadBuf[ch], rHeadBuf[0], numSamples);
 		}
 
-		const auto fbBuf = feedbackP(_feedback, numSamples);
 		const auto rHeadBufConst = readHeadBuffer.getArrayOfReadPointers();
 
-		const auto xFromHz = smooth::Lowpass<float>::getXFromHz(_damp, Fs);
-		const auto dampBuf = dampP(xFromHz, numSamples);
-
 		delay(samples, numChannels, numSamples,
-			wHead, fbBuf, dampBuf, rHeadBufConst);
+			wHead, prms[Feedback], prms[Damp], rHeadBufConst);
 	}
 }
\ No newline at end of file
@@ -30,6 +30,8 @@ namespace audio
 
 		static constexpr float LowestFrequencyHz = 20.f;
 
+		enum PRMLane { Feedback, Damp, Retune, NumPRMLanes };
+
 	public:
 		CombFilter(MIDIVoices&, const XenManager&);
 		
@@ -47,7 +49,7 @@ namespace audio
 		AudioBuffer readHeadBuffer;
 		DelayFeedback delay;
 
-		PRM feedbackP, dampP, retuneP;
+		SmoothBank prms;
 		
 		float Fs, sizeF, curDelay, curNote;
 		int size;
@@ -5,30 +5,8 @@ namespace audio
 	// MIDIManager
 
 	MIDIManager::MIDIManager(Params& params, State& state) :
-		midiLearn(params, state),
-		onInit(),
-		onEnd(),
-		onSample(),
-		onCC(),
-		onNoteOn(),
-		onNoteOff(),
-		onPitchbend(),
-		onNoEvt()
+		midiLearn(params, state)
 	{
-		onInit.push_back([&learn = midiLearn](int)
-		{
-			learn.processBlockInit();
-		});
-
-		onCC.push_back([&learn = midiLearn](const MIDIMessage& msg, int)
-		{
-			learn.processBlockMIDICC(msg);
-		});
-
-		onEnd.push_back([&learn = midiLearn](int)
-		{
-			learn.processBlockEnd();
-		});
 	}
 
 	void MIDIManager::savePatch()
@@ -41,84 +19,6 @@ namespace audio
 		midiLearn.loadPatch();
 	}
 
-	void MIDIManager::operator()(MIDIBuffer& midi, int numSamples) noexcept
-	{
-		if (midi.isEmpty())
-			processEmpty(numSamples);
-		else
-			processBlock(midi, numSamples);
-	}
-
-	void MIDIManager::processEmpty(int numSamples) noexcept
-	{
-		for (auto& func : onInit)
-			func(numSamples);
-		for (auto& func : onEnd)
-			func(numSamples);
-	}
-
-	void MIDIManager::processBlock(MIDIBuffer& midi, int numSamples) noexcept
-	{
-		for (auto& func : onInit)
-			func(numSamples);
-
-		auto evt = midi.begin();
-		auto ref = *evt;
-		auto ts = ref.samplePosition;
-		for (auto s = 0; s < numSamples; ++s)
-		{
-			if (ts > s)
-			{
-				for (auto& func : onNoEvt)
-					func(s);
-			}
-			else
-			{
-				//bool noteOn = env.noteOn;
-				while (ts == s)
-				{
-					const auto msg = ref.getMessage();
-
-					if (msg.isNoteOn())
-					{
-						for (auto& func : onNoteOn)
-							func(msg, s);
-					}
-					else if (msg.isNoteOff())
-					{
-						for (auto& func : onNoteOff)
-							func(msg, s);
-					}
-					else if (msg.isPitchWheel())
-					{
-						for (auto& func : onPitchbend)
-							func(msg, s);
-					}
-					else if (msg.isController())
-					{
-						for (auto& func : onCC)
-							func(msg, s);
-					}
-					++evt;
-					if (evt == midi.end())
-						ts = numSamples;
-					else
-					{
-						ref = *evt;
-						ts = ref.samplePosition;
-					}
-				}
-				for (auto& func : onSample)
-					func(s);
-				//bufNotes[s] = currentValue;
-				//bufEnv[s] = env(noteOn) * SafetyCoeff;
-			}
-		}
-
-		for (auto& func : onEnd)
-			func(numSamples);
-	}
-
 	// MIDINoteBuffer
 
 	MIDINoteBuffer::MIDINoteBuffer() :
@@ -128,9 +28,9 @@ namespace audio
 	{
 	}
 
-	void MIDINoteBuffer::prepare(int blockSize)
+	void MIDINoteBuffer::prepare(int blockSize, ScratchArena& arena)
 	{
-		buffer.resize(blockSize, curNote);
+		arena.request(buffer, blockSize);
 	}
 
 	void MIDINoteBuffer::processNoteOn(const MIDINote& nNote, int ts) noexcept
@@ -172,9 +72,9 @@ namespace audio
 	{
 	}
 
-	void MIDIPitchbendBuffer::prepare(int blockSize)
+	void MIDIPitchbendBuffer::prepare(int blockSize, ScratchArena& arena)
 	{
-		buffer.resize(blockSize, curPitchbend);
+		arena.request(buffer, blockSize);
 	}
 
 	void MIDIPitchbendBuffer::processInit() noexcept
@@ -203,46 +103,33 @@ namespace audio
 
 	// MIDIVoices
 
-	MIDIVoices::MIDIVoices(audio::MIDIManager& manager) :
+	MIDIVoices::MIDIVoices() :
 		voices(),
 		pitchbendBuffer(),
 		pitchbendRange(2.f),
 		voiceIndex(0)
 	{
-		manager.onInit.push_back([this](int)
-			{
-				for (auto& voice : voices)
-					voice.sampleIdx = 0;
-				pitchbendBuffer.processInit();
-			});
+	}
+
+	void MIDIVoices::midiInit(int) noexcept
+	{
+		for (auto& voice : voices)
+			voice.sampleIdx = 0;
+		pitchbendBuffer.processInit();
+	}
+
+	void MIDIVoices::midiNoteOn(const MIDIMessage& msg, int s) noexcept
+	{
 #if PPD_MIDINumVoices != 0
-		manager.onNoteOn.push_back([this](const MIDIMessage& msg, int s)
-			{
-				for (auto v = 1; v < PPD_MIDINumVoices; ++v)
-				{
-					auto nIdx = (voiceIndex + v) % PPD_MIDINumVoices;
-					auto& voice = voices[voiceIndex];
+		for (auto v = 1; v < PPD_MIDINumVoices; ++v)
+		{
+			auto nIdx = (voiceIndex + v) % PPD_MIDINumVoices;
+			auto& voice = voices[voiceIndex];
 
-					if (!voice.curNote.noteOn)
-					{
-						voiceIndex = nIdx;
-						voice.processNoteOn(
-							{
-								msg.getFloatVelocity(),
-								msg.getNoteNumber(),
-								true
-							},
-							s
-						);
-						return;
-					}
-				}
-
-				voiceIndex = (voiceIndex + 1) % PPD_MIDINumVoices;
-				auto& voice = voices[voiceIndex];
-
-				voice.processNoteOn
-				(
+			if (!voice.curNote.noteOn)
+			{
+				voiceIndex = nIdx;
+				voice.processNoteOn(
 					{
 						msg.getFloatVelocity(),
 						msg.getNoteNumber(),
@@ -250,42 +137,65 @@ namespace audio
 					},
 					s
 				);
-			});
+				return;
+			}
+		}
 
-		manager.onNoteOff.push_back([this](const MIDIMessage& msg, int s)
+		voiceIndex = (voiceIndex + 1) % PPD_MIDINumVoices;
+		auto& voice = voices[voiceIndex];
+
+		voice.processNoteOn
+		(
 			{
-				auto noteNumber = msg.getNoteNumber();
+				msg.getFloatVelocity(),
+				msg.getNoteNumber(),
+				true
+			},
+			s
+		);
+#else
+		juce::ignoreUnused(msg, s);
+#endif
+	}
 
-				for (auto v = 0; v < PPD_MIDINumVoices; ++v)
-				{
-					const auto v1 = (voiceIndex + 1 + v) % PPD_MIDINumVoices;
+	void MIDIVoices::midiNoteOff(const MIDIMessage& msg, int s) noexcept
+	{
+#if PPD_MIDINumVoices != 0
+		auto noteNumber = msg.getNoteNumber();
+
+		for (auto v = 0; v < PPD_MIDINumVoices; ++v)
+		{
+			const auto v1 = (voiceIndex + 1 + v) % PPD_MIDINumVoices;
 
-					auto& voice = voices[v1];
+			auto& voice = voices[v1];
 
-					if (voice.curNote.noteOn && voice.curNote.noteNumber == noteNumber)
-						return voice.processNoteOff(s);
-				}
-			});
+			if (voice.curNote.noteOn && voice.curNote.noteNumber == noteNumber)
+				return voice.processNoteOff(s);
+		}
+#else
+		juce::ignoreUnused(msg, s);
 #endif
-		manager.onPitchbend.push_back([this](const MIDIMessage& msg, int s)
-			{
-				const auto pwv = static_cast<float>(msg.getPitchWheelValue());
-				const auto pbNorm = (pwv - 8192.f) * .0001220703125f;
-				const auto val = pbNorm * pitchbendRange;
-				pitchbendBuffer.processPitchbend(val, s);
-			});
-		manager.onEnd.push_back([this](int numSamples)
-			{
-				for (auto& voice : voices)
-					voice.process(numSamples);
-				pitchbendBuffer.process(numSamples);
-			});
 	}
 
-	void MIDIVoices::prepare(int blockSize)
+	void MIDIVoices::midiPitchbend(const MIDIMessage& msg, int s) noexcept
+	{
+		const auto pwv = static_cast<float>(msg.getPitchWheelValue());
+		const auto pbNorm = (pwv - 8192.f) * .0001220703125f;
+		const auto val = pbNorm * pitchbendRange;
+		pitchbendBuffer.processPitchbend(val, s);
+	}
+
+	void MIDIVoices::midiEnd(int numSamples) noexcept
+	{
+		for (auto& voice : voices)
+			voice.process(numSamples);
+		pitchbendBuffer.process(numSamples);
+	}
+
+	void MIDIVoices::prepare(int blockSize, ScratchArena& arena)
 	{
 		for (auto& voice : voices)
-			voice.prepare(blockSize);
-		pitchbendBuffer.prepare(blockSize);
+			voice.prepare(blockSize, arena);
+		pitchbendBuffer.prepare(blockSize, arena);
 	}
 }
\ No newline at end of file
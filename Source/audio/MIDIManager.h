@@ -1,9 +1,39 @@
 #pragma once
 #include "MIDILearn.h"
-#include <functional>
+#include "ScratchArena.h"
 
 namespace audio
 {
+	/*
+	* receives the midi of each block from the MIDIManager.
+	* the block is split at the event timestamps: every event is passed once
+	* and every stretch of samples between events once as a range.
+	* handlers hide the no-ops they need, the manager calls them on the concrete types.
+	*/
+	struct MIDIHandler
+	{
+		/* numSamples */
+		void midiInit(int) noexcept {}
+
+		/* start, length. a range without events */
+		void midiRange(int, int) noexcept {}
+
+		/* midiMessage, sampleIndex */
+		void midiNoteOn(const MIDIMessage&, int) noexcept {}
+
+		/* midiMessage, sampleIndex */
+		void midiNoteOff(const MIDIMessage&, int) noexcept {}
+
+		/* midiMessage, sampleIndex */
+		void midiPitchbend(const MIDIMessage&, int) noexcept {}
+
+		/* midiMessage, sampleIndex */
+		void midiCC(const MIDIMessage&, int) noexcept {}
+
+		/* numSamples */
+		void midiEnd(int) noexcept {}
+	};
+
 	struct MIDIManager
 	{
 		MIDIManager(Params&, State&);
@@ -12,24 +42,51 @@ namespace audio
 
 		void loadPatch();
 
-		/* midiBuffer, numSamples */
-		void operator()(MIDIBuffer&, int) noexcept;
+		/* midiBuffer, numSamples, handlers. the handlers are visited at compile time, in order */
+		template<typename... Handlers>
+		void operator()(MIDIBuffer& midi, int numSamples, Handlers&... handlers) noexcept
+		{
+			midiLearn.processBlockInit();
+			(handlers.midiInit(numSamples), ...);
+
+			auto start = 0;
+			for (const auto ref : midi)
+			{
+				const auto ts = ref.samplePosition;
+				if (ts >= numSamples)
+					break;
+				if (ts > start)
+				{
+					(handlers.midiRange(start, ts - start), ...);
+					start = ts;
+				}
+				dispatch(ref.getMessage(), ts, handlers...);
+			}
+			if (start < numSamples)
+				(handlers.midiRange(start, numSamples - start), ...);
+
+			midiLearn.processBlockEnd();
+			(handlers.midiEnd(numSamples), ...);
+		}
 
 		MIDILearn midiLearn;
-
-		/* numSamples */
-		std::vector<std::function<void(int)>> onInit, onEnd, onSample;
-		/* midiMessage, sampleIndex */
-		std::vector<std::function<void(const MIDIMessage&, int)>> onCC, onNoteOn, onNoteOff, onPitchbend;
-		/* sampleIndex */
-		std::vector<std::function<void(int)>> onNoEvt;
 	protected:
-
-		/* numSamples */
-		void processEmpty(int) noexcept;
-
-		/* midiBuffer, numSamples */
-		void processBlock(MIDIBuffer&, int) noexcept;
+		/* midiMessage, sampleIndex, handlers */
+		template<typename... Handlers>
+		void dispatch(const MIDIMessage& msg, int s, Handlers&... handlers) noexcept
+		{
+			if (msg.isNoteOn())
+				(handlers.midiNoteOn(msg, s), ...);
+			else if (msg.isNoteOff())
+				(handlers.midiNoteOff(msg, s), ...);
+			else if (msg.isPitchWheel())
+				(handlers.midiPitchbend(msg, s), ...);
+			else if (msg.isController())
+			{
+				midiLearn.processBlockMIDICC(msg);
+				(handlers.midiCC(msg, s), ...);
+			}
+		}
 	};
 
 	struct MIDINote
@@ -43,8 +100,8 @@ namespace audio
 	{
 		MIDINoteBuffer();
 
-		/* blockSize */
-		void prepare(int);
+		/* blockSize, arena */
+		void prepare(int, ScratchArena&);
 		
 		/* newNote, timestamp */
 		void processNoteOn(const MIDINote&, int) noexcept;
@@ -55,7 +112,7 @@ namespace audio
 		/* numSamples */
 		void process(int) noexcept;
 
-		std::vector<MIDINote> buffer;
+		ScratchSpan<MIDINote> buffer;
 		MIDINote curNote;
 		int sampleIdx;
 	};
@@ -66,8 +123,8 @@ namespace audio
 	{
 		MIDIPitchbendBuffer();
 
-		/* blockSize */
-		void prepare(int);
+		/* blockSize, arena */
+		void prepare(int, ScratchArena&);
 
 		void processInit() noexcept;
 		
@@ -77,17 +134,28 @@ namespace audio
 		/* numSamples */
 		void process(int) noexcept;
 
-		std::vector<float> buffer;
+		ScratchSpan<float> buffer;
 		float curPitchbend;
 		int sampleIdx;
 	};
 
-	struct MIDIVoices
+	struct MIDIVoices :
+		public MIDIHandler
 	{
-		MIDIVoices(MIDIManager&);
+		MIDIVoices();
+
+		/* blockSize, arena */
+		void prepare(int, ScratchArena&);
+
+		void midiInit(int) noexcept;
+
+		void midiNoteOn(const MIDIMessage&, int) noexcept;
+
+		void midiNoteOff(const MIDIMessage&, int) noexcept;
+
+		void midiPitchbend(const MIDIMessage&, int) noexcept;
 
-		/* blockSize */
-		void prepare(int);
+		void midiEnd(int) noexcept;
 
 		MIDIVoicesArray voices;
 		MIDIPitchbendBuffer pitchbendBuffer;
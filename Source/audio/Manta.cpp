@@ -10,7 +10,7 @@ namespace audio
 	{}
 
 	void Manta::Filter::operator()(float* const* laneBuf, float* const* samples, int numChannels, int numSamples,
-		float* fcBuf, float* resoBuf, int stage) noexcept
+		const float* fcBuf, const float* resoBuf, int stage) noexcept
 	{
 		{
 			auto lane = laneBuf[0];
@@ -102,15 +102,15 @@ namespace audio
 	}
 
 	void Manta::RingMod::operator()(float* const* samples, int numChannels, int numSamples,
-		float* _rmDepth, float* _freqHz) noexcept
+		const float* _rmDepth, const float* _freqHz) noexcept
 	{
 		for (auto s = 0; s < numSamples; ++s)
 		{
 			const auto freqHz = _freqHz[s];
 			phasor.setFrequencyHz(freqHz);
-			auto p = phasor().phase;
-			oscBuffer[s] = waveTable(p);
+			oscBuffer[s] = phasor().phase;
 		}
+		waveTable(oscBuffer.data(), oscBuffer.data(), numSamples);
 
 		for (auto ch = 0; ch < numChannels; ++ch)
 		{
@@ -137,20 +137,22 @@ namespace audio
 		readHead(),
 		filter(),
 
-		frequency(.5f),
-		resonance(40.f),
-		drive(0.f),
-		feedback(0.f),
-		delayRate(0.f),
-		rmDepth(0.f),
-		rmFreqHz(420.f),
-		gain(1.f),
+		prms(),
 
 		delayFB(),
 
 		Fs(1.f),
 		delaySizeF(1.f)
-	{}
+	{
+		prms.addLane(.5f);
+		prms.addLane(40.f);
+		prms.addLane(0.f);
+		prms.addLane(0.f);
+		prms.addLane(0.f);
+		prms.addLane(0.f);
+		prms.addLane(420.f);
+		prms.addLane(1.f);
+	}
 
 	void Manta::Lane::prepare(float sampleRate, int blockSize, int delaySize)
 	{
@@ -158,14 +160,9 @@ namespace audio
 
 		laneBuffer.setSize(2, blockSize, false, true, false);
 
-		frequency.prepare(Fs, blockSize, 10.f);
-		resonance.prepare(Fs, blockSize, 10.f);
-		drive.prepare(Fs, blockSize, 10.f);
-		feedback.prepare(Fs, blockSize, 10.f);
-		delayRate.prepare(Fs, blockSize, 10.f);
-		gain.prepare(Fs, blockSize, 10.f);
-		rmDepth.prepare(Fs, blockSize, 10.f);
-		rmFreqHz.prepare(Fs, blockSize, 10.f);
+		prms.prepare(blockSize);
+		for (auto i = 0; i < NumPRMLanes; ++i)
+			prms.makeFromDecayInMs(i, 10.f, Fs);
 		delayFB.prepare(delaySize);
 		readHead.resize(blockSize, 0.f);
 		ringMod.prepare(Fs, blockSize);
@@ -191,37 +188,35 @@ namespace audio
 			SIMD::copy(lane[ch], samples[ch], numSamples);
 
 		const auto freqHz = xen.noteToFreqHzWithWrap(_pitch, 20.f);
+		const auto xenVal = xen.getXen();
+		const auto delayPitch = _pitch + _oct * xenVal + _semi;
+		const auto delayFreqHz = xen.noteToFreqHzWithWrap(delayPitch, 5.f);
+		const auto rmPitch = _pitch + _rmOct * xenVal + _rmSemi;
 
-		const auto fcBuf = frequency(freqHzInFc(freqHz, Fs), numSamples);
-		const auto resoBuf = resonance(_resonance, numSamples);
+		prms.setDest(Frequency, freqHzInFc(freqHz, Fs));
+		prms.setDest(Resonance, _resonance);
+		prms.setDest(Drive, _drive);
+		prms.setDest(Feedback, _feedback);
+		prms.setDest(DelayRate, freqHzInSamples(delayFreqHz, Fs));
+		prms.setDest(RMDepth, _rmDepth);
+		prms.setDest(RMFreqHz, xen.noteToFreqHzWithWrap(rmPitch, 5.f));
+		prms.setDest(Gain, decibelToGain(_gain));
+		prms(numSamples);
 
 		filter
 		(
 			lane, samples, numChannels, numSamples,
-			fcBuf, resoBuf, _slope
+			prms[Frequency], prms[Resonance], _slope
 		);
 
-		const auto xenVal = xen.getXen();
-
-		const auto feedbackBuf = feedback(_feedback, numSamples);
-		const auto delayPitch = _pitch + _oct * xenVal + _semi;
-		const auto delayFreqHz = xen.noteToFreqHzWithWrap(delayPitch, 5.f);
-		const auto delaySamples = freqHzInSamples(delayFreqHz, Fs);
-		const auto delayRateBuf = delayRate(delaySamples, numSamples);
-		const auto rHead = getRHead(numSamples, wHead, delayRateBuf);
-		delayFB(lane, numChannels, numSamples, wHead, rHead, feedbackBuf);
+		const auto rHead = getRHead(numSamples, wHead, prms[DelayRate]);
+		delayFB(lane, numChannels, numSamples, wHead, rHead, prms[Feedback]);
 
-		const auto driveBuf = drive(_drive, numSamples);
-		distort(lane, numChannels, numSamples, driveBuf);
+		distort(lane, numChannels, numSamples, prms[Drive]);
 
-		const auto rmPitch = _pitch + _rmOct * xenVal + _rmSemi;
-		const auto rmFreq = xen.noteToFreqHzWithWrap(rmPitch, 5.f);
-		const auto rmDepthBuf = rmDepth(_rmDepth, numSamples);
-		const auto rmFreqHzBuf = rmFreqHz(rmFreq, numSamples);
-		ringMod(lane, numChannels, numSamples, rmDepthBuf, rmFreqHzBuf);
+		ringMod(lane, numChannels, numSamples, prms[RMDepth], prms[RMFreqHz]);
 
-		const auto gainBuf = gain(decibelToGain(_gain), numSamples);
-		applyGain(lane, numChannels, numSamples, gainBuf);
+		applyGain(lane, numChannels, numSamples, prms[Gain]);
 	}
 
 	void Manta::Lane::savePatch(sta::State& state, int i)
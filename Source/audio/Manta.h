@@ -26,7 +26,7 @@ namespace audio
 
 			/* laneBuf, samples, numChannels, numSamples, fcBuf, resoBuf, stage */
 			void operator()(float* const*, float* const*, int, int,
-				float*, float*, int) noexcept;
+				const float*, const float*, int) noexcept;
 
 		protected:
 			std::array<Fltr, 2> filta;
@@ -58,7 +58,7 @@ namespace audio
 			void prepare(float, int);
 
 			/* samples, numChannels, numSamples, rmDepth, freqHz */
-			void operator()(float* const*, int, int, float*, float*) noexcept;
+			void operator()(float* const*, int, int, const float*, const float*) noexcept;
 
 			WT waveTable;
 		protected:
@@ -68,6 +68,9 @@ namespace audio
 
 		struct Lane
 		{
+			// the smoothed parameters of a lane
+			enum PRMLane { Frequency, Resonance, Drive, Feedback, DelayRate, RMDepth, RMFreqHz, Gain, NumPRMLanes };
+
 			Lane();
 
 			/* sampleRate, blockSize, delaySize */
@@ -92,7 +95,7 @@ namespace audio
 			AudioBuffer laneBuffer;
 			std::vector<float> readHead;
 			Filter filter;
-			PRM frequency, resonance, drive, feedback, delayRate, rmDepth, rmFreqHz, gain;
+			SmoothBank prms;
 			DelayFeedback delayFB;
 			float Fs, delaySizeF;
 
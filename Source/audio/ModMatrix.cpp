@@ -0,0 +1,225 @@
+#include "ModMatrix.h"
+
+namespace audio
+{
+	static_assert(static_cast<int>(PID::RetrigMode) - static_cast<int>(PID::ModPerlinRate) == ModMatrix::NumRoutes,
+		"one depth parameter per route");
+
+	ModMatrix::ModMatrix(Params& _params, State& _state) :
+		perlinRateHz(.5f),
+		perlinOctaves(3.f),
+		envRiseMs(5.f),
+		envFallMs(120.f),
+		ccNumber(1),
+		params(_params),
+		state(_state),
+		blockDepths(),
+		srcBuffers(),
+		destBuffers(),
+		baseBank(),
+		modBuffers(),
+		perlin(),
+		envFol(),
+		ccBuffer(),
+		fsInv(1.),
+		ccNumSamples(1)
+	{
+		for (auto dest = 0; dest < NumDests; ++dest)
+			baseBank.addLane(0.f);
+		blockDepths.fill(0.f);
+	}
+
+	void ModMatrix::midiInit(int) noexcept
+	{
+		ccBuffer.processInit();
+	}
+
+	void ModMatrix::midiCC(const MIDIMessage& msg, int s) noexcept
+	{
+		if (msg.getControllerNumber() != ccNumber.load())
+			return;
+		const auto val = static_cast<float>(msg.getControllerValue()) * CCValInv;
+		ccBuffer.processPitchbend(val, s);
+	}
+
+	void ModMatrix::midiEnd(int numSamples) noexcept
+	{
+		ccBuffer.process(numSamples);
+		ccNumSamples = numSamples;
+	}
+
+	void ModMatrix::savePatch()
+	{
+		state.set("modmatrix", "perlinrate", perlinRateHz.load(), true);
+		state.set("modmatrix", "perlinoct", perlinOctaves.load(), true);
+		state.set("modmatrix", "envrise", envRiseMs.load(), true);
+		state.set("modmatrix", "envfall", envFallMs.load(), true);
+		state.set("modmatrix", "cc", ccNumber.load(), true);
+	}
+
+	void ModMatrix::loadPatch()
+	{
+		auto var = state.get("modmatrix", "perlinrate");
+		if (var)
+			perlinRateHz.store(static_cast<float>(*var));
+		var = state.get("modmatrix", "perlinoct");
+		if (var)
+			perlinOctaves.store(juce::jlimit(1.f, static_cast<float>(Perlin::NumOctaves), static_cast<float>(*var)));
+		var = state.get("modmatrix", "envrise");
+		if (var)
+			envRiseMs.store(static_cast<float>(*var));
+		var = state.get("modmatrix", "envfall");
+		if (var)
+			envFallMs.store(static_cast<float>(*var));
+		var = state.get("modmatrix", "cc");
+		if (var)
+			ccNumber.store(juce::jlimit(0, 127, static_cast<int>(*var)));
+	}
+
+	void ModMatrix::prepare(float sampleRate, int blockSize, ScratchArena& arena)
+	{
+		fsInv = 1. / static_cast<double>(sampleRate);
+		for (auto& buf : srcBuffers)
+			arena.request(buf, blockSize);
+		for (auto& buf : destBuffers)
+			arena.request(buf, blockSize);
+		baseBank.prepare(blockSize);
+		for (auto dest = 0; dest < NumDests; ++dest)
+			baseBank.makeFromDecayInMs(dest, 20.f, sampleRate);
+		perlin.prepare(sampleRate, blockSize, arena);
+		envFol.prepare(sampleRate);
+		ccBuffer.prepare(blockSize, arena);
+	}
+
+	const ModMatrix::ModBuffers& ModMatrix::operator()(const float* const* samplesIn, int numChannelsIn, int numSamples,
+		const ParamsSnapshot& snap, const Perlin2& perlin2, bool temposync) noexcept
+	{
+		std::array<bool, NumSources> srcActive;
+		srcActive.fill(false);
+		auto anyActive = false;
+		for (auto src = 0; src < NumSources; ++src)
+			for (auto dest = 0; dest < NumDests; ++dest)
+			{
+				const auto r = routeIdx(src, dest);
+				blockDepths[r] = snap.getValModDenorm(param::offset(PID::ModPerlinRate, r));
+				if (blockDepths[r] != 0.f)
+				{
+					srcActive[src] = true;
+					anyActive = true;
+				}
+			}
+
+		// the bases keep tracking the parameters while no route is active
+		const auto ratePID = temposync ? PID::RateBeats : PID::RateHz;
+		baseBank.setDest(static_cast<int>(Dest::Rate), snap.getValMod(ratePID));
+		baseBank.setDest(static_cast<int>(Dest::Octaves), snap.getValMod(PID::Octaves));
+		baseBank.setDest(static_cast<int>(Dest::Phase), snap.getValMod(PID::Phase));
+		baseBank.setDest(static_cast<int>(Dest::Width), snap.getValMod(PID::Width));
+		baseBank(numSamples);
+
+		modBuffers = ModBuffers();
+		if (!anyActive)
+			return modBuffers;
+
+		if (srcActive[static_cast<int>(Source::Perlin)])
+			synthesizePerlin(numSamples, perlin2);
+		if (srcActive[static_cast<int>(Source::Envelope)])
+			synthesizeEnvelope(samplesIn, numChannelsIn, numSamples);
+		if (srcActive[static_cast<int>(Source::MIDICC)])
+			synthesizeMIDICC(numSamples);
+
+		modBuffers.rate = processDest(static_cast<int>(Dest::Rate), numSamples, params[ratePID]);
+		modBuffers.octaves = processDest(static_cast<int>(Dest::Octaves), numSamples, params[PID::Octaves]);
+		modBuffers.phase = processDest(static_cast<int>(Dest::Phase), numSamples, params[PID::Phase]);
+		// width is applied in the normalized range
+		modBuffers.width = processDest(static_cast<int>(Dest::Width), numSamples, nullptr);
+
+		return modBuffers;
+	}
+
+	int ModMatrix::routeIdx(int src, int dest) const noexcept
+	{
+		return src * NumDests + dest;
+	}
+
+	void ModMatrix::synthesizePerlin(int numSamples, const Perlin2& perlin2) noexcept
+	{
+		float* const samples[] = { srcBuffers[static_cast<int>(Source::Perlin)].data() };
+		perlin.updateSpeed(static_cast<double>(perlinRateHz.load()) * fsInv);
+
+		perlin
+		(
+			samples,
+			perlin2.getNoise().data(),
+			perlin2.gainBuffer.data(),
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			Perlin::Shape::Spline,
+			perlinOctaves.load(),
+			0.f,
+			0.f,
+			1,
+			numSamples,
+			false,
+			false,
+			false
+		);
+	}
+
+	void ModMatrix::synthesizeEnvelope(const float* const* samplesIn, int numChannelsIn, int numSamples) noexcept
+	{
+		auto buf = srcBuffers[static_cast<int>(Source::Envelope)].data();
+
+		if (numChannelsIn == 2)
+		{
+			SIMD::add(buf, samplesIn[0], samplesIn[1], numSamples);
+			SIMD::multiply(buf, .5f, numSamples);
+		}
+		else
+			SIMD::copy(buf, samplesIn[0], numSamples);
+		SIMD::abs(buf, buf, numSamples);
+
+		envFol(buf, buf, numSamples, envRiseMs.load(), envFallMs.load());
+	}
+
+	void ModMatrix::synthesizeMIDICC(int numSamples) noexcept
+	{
+		auto buf = srcBuffers[static_cast<int>(Source::MIDICC)].data();
+		const auto& cc = ccBuffer.buffer;
+
+		// midi is processed before upsampling
+		if (ccNumSamples == numSamples)
+			return SIMD::copy(buf, cc.data(), numSamples);
+
+		for (auto s = 0; s < numSamples; ++s)
+			buf[s] = cc[s * ccNumSamples / numSamples];
+	}
+
+	const float* ModMatrix::processDest(int dest, int numSamples, const Param* param) noexcept
+	{
+		auto routed = false;
+		for (auto src = 0; src < NumSources; ++src)
+			if (blockDepths[routeIdx(src, dest)] != 0.f)
+				routed = true;
+		if (!routed)
+			return nullptr;
+
+		auto buf = destBuffers[dest].data();
+		SIMD::copy(buf, baseBank[dest], numSamples);
+
+		for (auto src = 0; src < NumSources; ++src)
+		{
+			const auto depth = blockDepths[routeIdx(src, dest)];
+			if (depth != 0.f)
+				SIMD::addWithMultiply(buf, srcBuffers[src].data(), depth, numSamples);
+		}
+		SIMD::clip(buf, buf, 0.f, 1.f, numSamples);
+
+		if (param != nullptr)
+			param->denormalize(buf, numSamples);
+
+		return buf;
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "PerlinNoise.h"
+#include "EnvelopeFollower.h"
+#include "MIDIManager.h"
+
+namespace audio
+{
+	/*
+	* routes audio-rate modulation sources into the perlin parameters.
+	* every source/destination pair is one route with a depth [-1, 1], a parameter from PID::ModPerlinRate on.
+	* the whole matrix is skipped if all depths are 0.
+	*/
+	struct ModMatrix :
+		public MIDIHandler
+	{
+		enum class Source { Perlin, Envelope, MIDICC, NumSources };
+		enum class Dest { Rate, Octaves, Phase, Width, NumDests };
+
+		static constexpr int NumSources = static_cast<int>(Source::NumSources);
+		static constexpr int NumDests = static_cast<int>(Dest::NumDests);
+		static constexpr int NumRoutes = NumSources * NumDests;
+		static constexpr float CCValInv = 1.f / 127.f;
+
+		using ModBuffers = Perlin2::ModBuffers;
+		using ParamsSnapshot = param::ParamsSnapshot;
+
+		/* params, state */
+		ModMatrix(Params&, State&);
+
+		void savePatch();
+
+		void loadPatch();
+
+		/* sampleRate, blockSize, arena */
+		void prepare(float, int, ScratchArena&);
+
+		void midiInit(int) noexcept;
+
+		void midiCC(const MIDIMessage&, int) noexcept;
+
+		void midiEnd(int) noexcept;
+
+		/* samplesIn, numChannelsIn, numSamples, snapshot, perlin, temposync
+		returns the modulated parameter buffers, all nullptr if no route is active */
+		const ModBuffers& operator()(const float* const*, int, int,
+			const ParamsSnapshot&, const Perlin2&, bool) noexcept;
+
+		// perlin source
+		std::atomic<float> perlinRateHz, perlinOctaves;
+		// envelope source
+		std::atomic<float> envRiseMs, envFallMs;
+		// midi cc source
+		std::atomic<int> ccNumber;
+	protected:
+		Params& params;
+		State& state;
+
+		std::array<float, NumRoutes> blockDepths;
+		std::array<ScratchSpan<float>, NumSources> srcBuffers;
+		std::array<ScratchSpan<float>, NumDests> destBuffers;
+		// one lane per destination
+		SmoothBank baseBank;
+		ModBuffers modBuffers;
+
+		Perlin perlin;
+		EnvFol envFol;
+		// a pitchbend buffer is just a stepped value buffer
+		MIDIPitchbendBuffer ccBuffer;
+		double fsInv;
+		int ccNumSamples;
+
+		/* src, dest */
+		int routeIdx(int, int) const noexcept;
+
+		/* numSamples, perlin2 */
+		void synthesizePerlin(int, const Perlin2&) noexcept;
+
+		/* samplesIn, numChannelsIn, numSamples */
+		void synthesizeEnvelope(const float* const*, int, int) noexcept;
+
+		/* numSamples */
+		void synthesizeMIDICC(int) noexcept;
+
+		/* dest, numSamples, param (denormalizing) */
+		const float* processDest(int, int, const Param*) noexcept;
+	};
+}
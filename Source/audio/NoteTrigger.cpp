@@ -0,0 +1,56 @@
+#include "NoteTrigger.h"
+
+namespace audio
+{
+	NoteTrigger::NoteTrigger() :
+		mode(Retrig::Off),
+		channel(0),
+		keyLow(0),
+		keyHigh(127),
+		triggers(),
+		scaled(),
+		numTriggers(0),
+		midiNumSamples(1)
+	{
+	}
+
+	void NoteTrigger::midiInit(int) noexcept
+	{
+		numTriggers = 0;
+	}
+
+	void NoteTrigger::midiNoteOn(const MIDIMessage& msg, int s) noexcept
+	{
+		if (mode == Retrig::Off || numTriggers == MaxTriggers)
+			return;
+		if (channel != 0 && msg.getChannel() != channel)
+			return;
+		const auto note = msg.getNoteNumber();
+		if (note < keyLow || note > keyHigh)
+			return;
+
+		triggers[numTriggers] = { s, note };
+		++numTriggers;
+	}
+
+	void NoteTrigger::midiEnd(int numSamples) noexcept
+	{
+		midiNumSamples = numSamples;
+	}
+
+	const NoteTrigger::Trigger* NoteTrigger::getTriggers(int numSamples) noexcept
+	{
+		// midi is processed before upsampling
+		if (midiNumSamples == numSamples)
+			return triggers.data();
+
+		for (auto t = 0; t < numTriggers; ++t)
+			scaled[t] = { triggers[t].ts * numSamples / midiNumSamples, triggers[t].note };
+		return scaled.data();
+	}
+
+	int NoteTrigger::getNumTriggers() const noexcept
+	{
+		return numTriggers;
+	}
+}
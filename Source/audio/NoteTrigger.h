@@ -0,0 +1,40 @@
+#pragma once
+#include "PerlinNoise.h"
+#include "MIDIManager.h"
+
+namespace audio
+{
+	/*
+	* collects the note-ons that retrigger the perlin noise, with their sample offsets.
+	* notes can be filtered by channel and key range.
+	*/
+	struct NoteTrigger :
+		public MIDIHandler
+	{
+		using Retrig = Perlin2::Retrig;
+		using Trigger = Perlin2::Trigger;
+
+		static constexpr int MaxTriggers = 128;
+
+		NoteTrigger();
+
+		void midiInit(int) noexcept;
+
+		void midiNoteOn(const MIDIMessage&, int) noexcept;
+
+		void midiEnd(int) noexcept;
+
+		/* numSamples, returns the triggers of the last midi block scaled to numSamples */
+		const Trigger* getTriggers(int) noexcept;
+
+		int getNumTriggers() const noexcept;
+
+		// set from PID::RetrigMode, RetrigChannel, RetrigKeyLow and RetrigKeyHigh before the midi of each block
+		Retrig mode;
+		// 0 = omni
+		int channel, keyLow, keyHigh;
+	protected:
+		std::array<Trigger, MaxTriggers> triggers, scaled;
+		int numTriggers, midiNumSamples;
+	};
+}
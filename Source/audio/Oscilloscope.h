@@ -1,80 +1,140 @@
 #pragma once
 #include "AudioUtils.h"
-#include "WHead.h"
 #include "Phasor.h"
 
 namespace audio
 {
+	/*
+	* feeds the scope with a min/max pyramid of one bar of the (mono) signal.
+	* level 0 splits the 4 second window into NumBins bins, every further level halves that.
+	* the pyramid is published through a lock-free triple buffer at PublishHz,
+	* so the gui always reads a whole frame and only the level that fits its width.
+	*/
 	struct Oscilloscope
 	{
+		static constexpr int NumBins = 1 << 12;
+		static constexpr int NumLevels = 7;
+		static constexpr int PyramidSize = 2 * NumBins - (NumBins >> (NumLevels - 1));
+		static constexpr int PublishHz = 60;
+		static constexpr int NewFrame = 4;
+		static constexpr int IndexMask = NewFrame - 1;
+
+		struct Frame
+		{
+			Frame() :
+				mins(PyramidSize, 0.f),
+				maxs(PyramidSize, 0.f),
+				beatLength(1.f),
+				samplesPerBin(1.f),
+				writeBin(0),
+				sequence(0)
+			{}
+
+			// all levels, level 0 first
+			std::vector<float> mins, maxs;
+			// in samples
+			float beatLength, samplesPerBin;
+			// the level 0 bin that is being written
+			int writeBin;
+			unsigned int sequence;
+		};
+
+		/* level */
+		static int getLevelOffset(int level) noexcept
+		{
+			return 2 * (NumBins - (NumBins >> level));
+		}
+
+		/* level */
+		static int getNumBins(int level) noexcept
+		{
+			return NumBins >> level;
+		}
+
 		Oscilloscope() :
-			wHead(),
-			buffer(),
+			frames(),
+			binMin(NumBins, 0.f),
+			binMax(NumBins, 0.f),
 			phasor(0.),
+			middleIdx(1),
+			sequence(0),
+			Fs(0.),
 			beatLength(1.f),
-			Fs(0.)
+			windowSize(1),
+			samplesPerBin(1),
+			writePos(0),
+			lastBin(-1),
+			publishInterval(1),
+			publishCountdown(1),
+			frontIdx(0),
+			backIdx(2)
 		{}
 
-		void prepare(double sampleRate, int blockSize)
+		void prepare(double sampleRate, int)
 		{
 			Fs = sampleRate;
 
-			auto windowSize = static_cast<int>(Fs) * 4;
-			wHead.prepare(blockSize, windowSize);
-			buffer.resize(windowSize);
+			windowSize = static_cast<int>(Fs) * 4;
+			samplesPerBin = (windowSize + NumBins - 1) / NumBins;
+			writePos = 0;
+			lastBin = -1;
+			publishInterval = std::max(1, static_cast<int>(Fs) / PublishHz);
+			publishCountdown = publishInterval;
 
 			phasor.prepare(1. / Fs);
 		}
 
 		void operator()(const float** samples, int numChannels, int numSamples,
 			const PlayHeadPos& playHead) noexcept
-		{	
-			wHead(numSamples);
-			
-			const auto rateSyncV = 1.;
-
-			const auto bpm = playHead.bpm;
-			const auto bps = bpm * .0166666667;
-			const auto quarterNoteLengthInSamples = Fs / bps;
-			const auto barLengthInSamples = quarterNoteLengthInSamples * 4.;
-			const auto beatLen = barLengthInSamples * rateSyncV;
-			phasor.inc = 1. / beatLen;
-			beatLength.store(static_cast<float>(beatLen));
-			
-			const auto ppq = playHead.ppqPosition * .25;
-			const auto ppqCh = ppq / rateSyncV;
-
-			phasor.phase.phase = ppqCh - std::floor(ppqCh);
-
-			for (auto s = 0; s < numSamples; ++s)
-			{
-				auto w = wHead[s];
-				
-				const auto phaseInfo = phasor();
-				if (phaseInfo.retrig)
-				{
-					wHead.shift(-w, numSamples);
-					w = wHead[s];
-				}
+		{
+			updatePhasor(playHead);
 
-				buffer[w] = samples[0][s];
-			}
-			
 			if (numChannels == 2)
-			{
 				for (auto s = 0; s < numSamples; ++s)
-				{
-					const auto w = wHead[s];
-					buffer[w] = (buffer[w] + samples[1][s]) * .5f;
-				}
-			}
+					write((samples[0][s] + samples[1][s]) * .5f);
+			else
+				for (auto s = 0; s < numSamples; ++s)
+					write(samples[0][s]);
 		}
 
 		void operator()(const float* samples, int numSamples,
 			const PlayHeadPos& playHead) noexcept
 		{
-			wHead(numSamples);
+			updatePhasor(playHead);
+
+			for (auto s = 0; s < numSamples; ++s)
+				write(samples[s]);
+		}
 
+		/* returns the latest published frame. only call this from one (the message) thread */
+		const Frame& read() noexcept
+		{
+			if (middleIdx.load() & NewFrame)
+				frontIdx = middleIdx.exchange(frontIdx) & IndexMask;
+			return frames[frontIdx];
+		}
+
+		/* the sequence number of the latest published frame */
+		unsigned int getSequence() const noexcept
+		{
+			return sequence.load();
+		}
+	protected:
+		std::array<Frame, 3> frames;
+		std::vector<float> binMin, binMax;
+		Phasor<double> phasor;
+		std::atomic<int> middleIdx;
+		std::atomic<unsigned int> sequence;
+		double Fs;
+		float beatLength;
+		int windowSize, samplesPerBin, writePos, lastBin, publishInterval, publishCountdown;
+		// only touched by the reader
+		int frontIdx;
+		// only touched by the writer
+		int backIdx;
+
+		void updatePhasor(const PlayHeadPos& playHead) noexcept
+		{
 			const auto rateSyncV = 1.;
 
 			const auto bpm = playHead.bpm;
@@ -83,47 +143,69 @@ namespace audio
 			const auto barLengthInSamples = quarterNoteLengthInSamples * 4.;
 			const auto beatLen = barLengthInSamples * rateSyncV;
 			phasor.inc = 1. / beatLen;
-			beatLength.store(static_cast<float>(beatLen));
+			beatLength = static_cast<float>(beatLen);
 
 			const auto ppq = playHead.ppqPosition * .25;
 			const auto ppqCh = ppq / rateSyncV;
 
 			phasor.phase.phase = ppqCh - std::floor(ppqCh);
+		}
 
-			for (auto s = 0; s < numSamples; ++s)
+		/* smpl */
+		void write(float smpl) noexcept
+		{
+			if (phasor().retrig)
+				writePos = 0;
+
+			const auto bin = writePos / samplesPerBin;
+			if (bin != lastBin)
 			{
-				auto w = wHead[s];
+				// a new pass over this bin overwrites the previous bar
+				binMin[bin] = binMax[bin] = smpl;
+				lastBin = bin;
+			}
+			else
+			{
+				binMin[bin] = std::min(binMin[bin], smpl);
+				binMax[bin] = std::max(binMax[bin], smpl);
+			}
 
-				const auto phaseInfo = phasor();
-				if (phaseInfo.retrig)
-				{
-					wHead.shift(-w, numSamples);
-					w = wHead[s];
-				}
+			if (++writePos == windowSize)
+				writePos = 0;
 
-				buffer[w] = samples[s];
-			}
+			if (--publishCountdown == 0)
+				publish();
 		}
 
-		const float* data() const noexcept
-		{
-			return buffer.data();
-		}
-		
-		const size_t windowLength() const noexcept
+		void publish() noexcept
 		{
-			return buffer.size();
-		}
+			publishCountdown = publishInterval;
 
-		const float getBeatLength() const noexcept
-		{
-			return beatLength.load();
+			auto& frame = frames[backIdx];
+			auto mins = frame.mins.data();
+			auto maxs = frame.maxs.data();
+			SIMD::copy(mins, binMin.data(), NumBins);
+			SIMD::copy(maxs, binMax.data(), NumBins);
+
+			for (auto level = 1; level < NumLevels; ++level)
+			{
+				const auto src = getLevelOffset(level - 1);
+				const auto dest = getLevelOffset(level);
+				const auto numBins = getNumBins(level);
+				for (auto b = 0; b < numBins; ++b)
+				{
+					mins[dest + b] = std::min(mins[src + 2 * b], mins[src + 2 * b + 1]);
+					maxs[dest + b] = std::max(maxs[src + 2 * b], maxs[src + 2 * b + 1]);
+				}
+			}
+
+			frame.beatLength = beatLength;
+			frame.samplesPerBin = static_cast<float>(samplesPerBin);
+			frame.writeBin = writePos / samplesPerBin;
+			frame.sequence = sequence.load() + 1;
+
+			backIdx = middleIdx.exchange(backIdx | NewFrame) & IndexMask;
+			sequence.store(frame.sequence);
 		}
-	protected:
-		WHead wHead;
-		std::vector<float> buffer;
-		Phasor<double> phasor;
-		std::atomic<float> beatLength;
-		double Fs;
 	};
-}
\ No newline at end of file
+}
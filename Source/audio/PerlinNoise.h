@@ -1,8 +1,10 @@
 #pragma once
 #include <array>
 #include <random>
+#include <thread>
 #include "Phasor.h"
 #include "PRM.h"
+#include "ScratchArena.h"
 #include "../arch/Interpolation.h"
 
 #define oopsie(x) jassert(!(x))
@@ -64,17 +66,28 @@ namespace audio
 			// phase
 			phasor(),
 			phaseBuffer(),
+			octPhaseBuffer(),
+			octBuffer(),
 			noiseIdx(0)
 		{
 		}
 
-		/* sampleRate, blockSize */
-		void prepare(float _sampleRate, int blockSize)
+		/* sampleRate, blockSize, arena */
+		void prepare(float _sampleRate, int blockSize, ScratchArena& arena)
 		{
 			fs = _sampleRate;
 			const auto fsInv = 1.f / fs;
 			sampleRateInv = static_cast<double>(fsInv);
-			phaseBuffer.resize(blockSize);
+			arena.request(phaseBuffer, blockSize);
+			arena.request(octPhaseBuffer, blockSize);
+			arena.request(octBuffer, blockSize);
+		}
+
+		/* other */
+		void copyPhase(const Perlin& other) noexcept
+		{
+			phasor = other.phasor;
+			noiseIdx = other.noiseIdx;
 		}
 
 		/* rateHzInv */
@@ -104,17 +117,21 @@ namespace audio
 		}
 
 		/* samples, noise, gainBuffer,
-		octavesBuffer, phsBuf, widthBuf, shape,
+		octavesBuffer, phsBuf, widthBuf, incBuf, shape,
 		octaves, width, phs
 		numChannels, numSamples,
-		octavesSmoothing, phsSmoothing, widthSmoothing */
+		octavesSmoothing, phsSmoothing, widthSmoothing
+		incBuf is nullptr if the speed is constant during the block */
 		void operator()(float* const* samples, const float* noise, const float* gainBuffer,
-			const float* octavesBuf, const float* phsBuf, const float* widthBuf, Shape shape,
+			const float* octavesBuf, const float* phsBuf, const float* widthBuf, const float* incBuf, Shape shape,
 			float octaves, float width, float phs,
 			int numChannels, int numSamples,
 			bool octavesSmoothing, bool phsSmoothing, bool widthSmoothing) noexcept
 		{
-			synthesizePhasor(phsBuf, phs, numSamples, phsSmoothing);
+			if (incBuf != nullptr)
+				synthesizePhasorModulated(phsBuf, incBuf, phs, numSamples, phsSmoothing);
+			else
+				synthesizePhasor(phsBuf, phs, numSamples, phsSmoothing);
 			
 			processOctaves(samples[0], octavesBuf, noise, gainBuffer, octaves, shape, numSamples, octavesSmoothing);
 			
@@ -129,7 +146,7 @@ namespace audio
 		
 		// phase
 		Phasor<double> phasor;
-		std::vector<float> phaseBuffer;
+		ScratchSpan<float> phaseBuffer, octPhaseBuffer, octBuffer;
 		int noiseIdx;
 		
 	protected:
@@ -156,6 +173,21 @@ namespace audio
 				}
 		}
 
+		/* phsBuf, incBuf, phs, numSamples, phaseSmoothing */
+		void synthesizePhasorModulated(const float* phsBuf, const float* incBuf, float phs, int numSamples, bool phaseSmoothing) noexcept
+		{
+			for (auto s = 0; s < numSamples; ++s)
+			{
+				phasor.inc = static_cast<double>(incBuf[s]);
+				const auto phaseInfo = phasor();
+				if (phaseInfo.retrig)
+					noiseIdx = (noiseIdx + 1) & NoiseSizeMax;
+
+				const auto p = phaseSmoothing ? phsBuf[s] : phs;
+				phaseBuffer[s] = static_cast<float>(phaseInfo.phase) + p + static_cast<float>(noiseIdx);
+			}
+		}
+
 		/* smpls, octavesBuf, noise, gainBuffer, shape, numSamples, octavesSmoothing */
 		void processOctaves(float* smpls, const float* octavesBuf,
 			const float* noise, const float* gainBuffer, float octaves, Shape shape, int numSamples,
@@ -172,41 +204,52 @@ namespace audio
 			return interpolationFuncs[static_cast<int>(shape)](noise, phase);
 		}
 
+		/* dest, noise, phase, shape, numSamples */
+		void getInterpolatedBlock(float* dest, const float* noise, const float* phase,
+			Shape shape, int numSamples) noexcept
+		{
+			switch (shape)
+			{
+			case Shape::NN:
+				for (auto s = 0; s < numSamples; ++s)
+					dest[s] = getInterpolatedNN(noise, phase[s]);
+				return;
+			case Shape::Lerp:
+				SIMD::add(dest, phase, 1.5f, numSamples);
+				return interpolate::block::lerp(dest, noise, dest, numSamples);
+			default:
+				return interpolate::block::cubicHermiteSpline(dest, noise, phase, numSamples);
+			}
+		}
+
+		/* smpls, noise, octave, shape, numSamples, gain */
+		void addOctave(float* smpls, const float* noise, int o, Shape shape, int numSamples, float gain) noexcept
+		{
+			for (auto s = 0; s < numSamples; ++s)
+				octPhaseBuffer[s] = getPhaseOctaved(phaseBuffer[s], o);
+			getInterpolatedBlock(octBuffer.data(), noise, octPhaseBuffer.data(), shape, numSamples);
+			SIMD::addWithMultiply(smpls, octBuffer.data(), gain, numSamples);
+		}
+
 		/* smpls, noise, gainBuffer, octaves, shape, numSamples */
 		void processOctavesNotSmoothing(float* smpls, const float* noise,
 			const float* gainBuffer, float octaves, Shape shape, int numSamples) noexcept
 		{
 			const auto octFloor = std::floor(octaves);
+			const auto octFloorInt = static_cast<int>(octFloor);
 
-			for (auto s = 0; s < numSamples; ++s)
-			{
-				auto sample = 0.f;
-				for (auto o = 0; o < octFloor; ++o)
-				{
-					const auto phase = getPhaseOctaved(phaseBuffer[s], o);
-					const auto smpl = getInterpolatedSample(noise, phase, shape);
-					sample += smpl * gainBuffer[o];
-				}
-
-				smpls[s] = sample;
-			}
-
+			SIMD::clear(smpls, numSamples);
 			auto gain = 0.f;
-			for (auto o = 0; o < octFloor; ++o)
+			for (auto o = 0; o < octFloorInt; ++o)
+			{
+				addOctave(smpls, noise, o, shape, numSamples, gainBuffer[o]);
 				gain += gainBuffer[o];
+			}
 
 			const auto octFrac = octaves - octFloor;
 			if (octFrac != 0.f)
 			{
-				const auto octFloorInt = static_cast<int>(octFloor);
-
-				for (auto s = 0; s < numSamples; ++s)
-				{
-					const auto phase = getPhaseOctaved(phaseBuffer[s], octFloorInt);
-					const auto smpl = getInterpolatedSample(noise, phase, shape);
-					smpls[s] += octFrac * smpl * gainBuffer[octFloorInt];;
-				}
-
+				addOctave(smpls, noise, octFloorInt, shape, numSamples, octFrac * gainBuffer[octFloorInt]);
 				gain += octFrac * gainBuffer[octFloorInt];
 			}
 
@@ -306,103 +349,280 @@ namespace audio
 		using AudioBuffer = juce::AudioBuffer<float>;
 		using Shape = Perlin::Shape;
 
+		// handshake between setSeed and the audio thread
+		enum class SeedStage { Idle, Writing, Ready, Reading };
+
+		// what a note trigger does: restart the noise, jump to a per-note position or restart it with a crossfade
+		enum class Retrig { Off, Phase, Reseed, Fade, NumRetrigs };
+
+		// a note-on at a sample of the block
+		struct Trigger
+		{
+			int ts, note;
+		};
+
+		// the noise position of a reseeding note is derived from its note number
+		static constexpr int ReseedStride = 37;
+
+		// per-sample modulation of the parameters, nullptr if not modulated
+		struct ModBuffers
+		{
+			ModBuffers() :
+				rate(nullptr),
+				octaves(nullptr),
+				phase(nullptr),
+				width(nullptr)
+			{}
+
+			// rate is in hz or beats, depending on temposync
+			const float *rate, *octaves, *phase, *width;
+		};
+
 		Perlin2() :
 			// misc
 			sampleRateInv(1.),
 			// noise
-			noise(),
+			noises(),
 			gainBuffer(),
 			// perlin
 			prevBuffer(),
 			perlins(),
 			perlinIndex(0),
 			// parameters
-			octavesPRM(1.f),
-			widthPRM(0.f),
-			phsPRM(0.f),
+			smoothBank(),
+			octavesLane(smoothBank.addLane(1.f)),
+			widthLane(smoothBank.addLane(0.f)),
+			phsLane(smoothBank.addLane(0.f)),
 			rateBeats(-1.),
 			rateHz(-1.),
 			rateInv(0.),
+			// rate modulation
+			incBuffer(),
 			// crossfade
 			xFadeBuffer(),
 			xPhase(0.f),
 			xInc(0.f),
 			crossfading(false),
 			seed(),
+			seedNoise(),
+			seedStage(SeedStage::Idle),
+			seedCrossfade(false),
 			// project position
 			curPosEstimate(-1),
-			curPosInSamples(0)
+			curPosInSamples(0),
+			lastJumpFrom(-1),
+			lastJumpTo(-1),
+			ppqEstimate(0.)
 		{
-			setSeed(69420);
-			
-			for (auto s = 0; s < Perlin::NoiseOvershoot; ++s)
-				noise[Perlin::NoiseSize + s] = noise[s];
+			setSeed(69420, false);
 
 			for (auto o = 0; o < gainBuffer.size(); ++o)
 				gainBuffer[o] = 1.f / static_cast<float>(1 << o);
 		}
 
-		void setSeed(int _seed)
+		/* noise, seed */
+		static void generateNoise(Perlin::NoiseArray& nNoise, int _seed)
+		{
+			generateProceduralNoise(nNoise.data(), Perlin::NoiseSize, static_cast<unsigned int>(_seed));
+			for (auto s = 0; s < Perlin::NoiseOvershoot; ++s)
+				nNoise[Perlin::NoiseSize + s] = nNoise[s];
+		}
+
+		/* seed, crossfade
+		without crossfade the noise is replaced immediately, so only use that while not processing.
+		with crossfade the audio thread picks up the new noise at the next block
+		and crossfades into it, so this never blocks or mutes the audio thread. */
+		void setSeed(int _seed, bool crossfade = true)
 		{
 			seed.store(_seed);
-			generateProceduralNoise(noise.data(), Perlin::NoiseSize, static_cast<unsigned int>(_seed));
+
+			if (!crossfade)
+			{
+				// a pending crossfade would replace this noise again
+				auto expected = SeedStage::Ready;
+				seedStage.compare_exchange_strong(expected, SeedStage::Idle);
+				generateNoise(noises[0], _seed);
+				noises[1] = noises[0];
+				return;
+			}
+
+			Perlin::NoiseArray nNoise;
+			generateNoise(nNoise, _seed);
+
+			while (true)
+			{
+				auto stage = seedStage.load();
+				if (stage == SeedStage::Idle || stage == SeedStage::Ready)
+				{
+					if (seedStage.compare_exchange_weak(stage, SeedStage::Writing))
+						break;
+				}
+				else
+					std::this_thread::yield();
+			}
+			seedNoise = nNoise;
+			seedStage.store(SeedStage::Ready);
 		}
 
-		void prepare(float fs, int blockSize)
+		const Perlin::NoiseArray& getNoise() const noexcept
+		{
+			return noises[perlinIndex];
+		}
+
+		/* sampleRate, blockSize, arena */
+		void prepare(float fs, int blockSize, ScratchArena& arena)
 		{
 			const auto fsInv = 1.f / fs;
 			sampleRateInv = static_cast<double>(fsInv);
 
-			prevBuffer.setSize(2, blockSize, false, false, false);
+			for (auto& prev : prevBuffer)
+				arena.request(prev, blockSize);
 			for (auto& perlin : perlins)
-				perlin.prepare(fs, blockSize);
+				perlin.prepare(fs, blockSize, arena);
 			xInc = msInInc(420.f, fs);
-			xFadeBuffer.resize(blockSize);
-			octavesPRM.prepare(fs, blockSize, 10.f);
-			widthPRM.prepare(fs, blockSize, 20.f);
-			phsPRM.prepare(fs, blockSize, 20.f);
+			arena.request(xFadeBuffer, blockSize);
+			arena.request(incBuffer, blockSize);
+			smoothBank.prepare(blockSize);
+			smoothBank.makeFromDecayInMs(octavesLane, 10.f, fs);
+			smoothBank.makeFromDecayInMs(widthLane, 20.f, fs);
+			smoothBank.makeFromDecayInMs(phsLane, 20.f, fs);
 		}
 
 		/* samples, numChannels, numSamples, playHeadPos,
 		rateHz, rateBeats, octaves, width, phs, shape,
-		temposync, procedural */
+		temposync, procedural, mod,
+		triggers, numTriggers, retrig
+		the block is rendered in segments that start at the triggers' timestamps (sorted).
+		procedural playback derives its phase from the playhead, so it ignores the triggers. */
 		void operator()(float* const* samples, int numChannels, int numSamples,
 			const PlayHeadPos& playHeadPos,
 			double _rateHz, double _rateBeats,
 			float octaves, float width, float phs,
-			Shape shape, bool temposync, bool procedural) noexcept
+			Shape shape, bool temposync, bool procedural,
+			const ModBuffers& mod,
+			const Trigger* triggers, int numTriggers, Retrig retrig) noexcept
 		{
+			processSeed();
+
 			if(temposync)
 				processSync(playHeadPos, numSamples, _rateBeats, procedural);
 			else
 				processFree(playHeadPos, numSamples, _rateHz, procedural);
 
-			const auto octavesBuf = octavesPRM(octaves, numSamples);
-			const auto phsBuf = phsPRM(phs, numSamples);
-			const auto widthBuf = widthPRM(width, numSamples);
+			const auto incBuf = processRateMod(playHeadPos, mod.rate, numSamples, temposync, procedural);
+
+			// the smoothers keep tracking the parameters while they are modulated
+			smoothBank.setDest(octavesLane, octaves);
+			smoothBank.setDest(phsLane, phs);
+			smoothBank.setDest(widthLane, width);
+			smoothBank(numSamples);
+			const float* octavesBuf = smoothBank[octavesLane];
+			const float* phsBuf = smoothBank[phsLane];
+			const float* widthBuf = smoothBank[widthLane];
+			auto octavesSmoothing = smoothBank.isSmoothing(octavesLane);
+			auto phsSmoothing = smoothBank.isSmoothing(phsLane);
+			auto widthSmoothing = smoothBank.isSmoothing(widthLane);
+			if (mod.octaves != nullptr)
+			{
+				octavesBuf = mod.octaves;
+				octavesSmoothing = true;
+			}
+			if (mod.phase != nullptr)
+			{
+				phsBuf = mod.phase;
+				phsSmoothing = true;
+			}
+			if (mod.width != nullptr)
+			{
+				widthBuf = mod.width;
+				widthSmoothing = true;
+			}
+
+			auto start = 0;
+			if (retrig != Retrig::Off && !(procedural && playHeadPos.isPlaying))
+				for (auto t = 0; t < numTriggers; ++t)
+				{
+					const auto ts = juce::jlimit(start, numSamples, triggers[t].ts);
+					processSegment(samples, numChannels, start, ts - start,
+						octavesBuf, phsBuf, widthBuf, incBuf, octaves, width, phs, shape,
+						octavesSmoothing, phsSmoothing, widthSmoothing);
+					processTrigger(triggers[t].note, retrig);
+					start = ts;
+				}
+			processSegment(samples, numChannels, start, numSamples - start,
+				octavesBuf, phsBuf, widthBuf, incBuf, octaves, width, phs, shape,
+				octavesSmoothing, phsSmoothing, widthSmoothing);
+		}
+		
+		// misc
+		double sampleRateInv;
+		// noise (one table per perlin, so that seed changes can crossfade)
+		std::array<Perlin::NoiseArray, 2> noises;
+		Perlin::GainBuffer gainBuffer;
+		// perlin
+		std::array<ScratchSpan<float>, 2> prevBuffer;
+		std::array<Perlin, 2> perlins;
+		int perlinIndex;
+		// parameters
+		SmoothBank smoothBank;
+		int octavesLane, widthLane, phsLane;
+		double rateBeats, rateHz;
+		double rateInv;
+		// rate modulation
+		ScratchSpan<float> incBuffer;
+		// crossfade
+		ScratchSpan<float> xFadeBuffer;
+		float xPhase, xInc;
+		bool crossfading;
+		// seed
+		std::atomic<int> seed;
+		Perlin::NoiseArray seedNoise;
+		std::atomic<SeedStage> seedStage;
+		bool seedCrossfade;
+		// project position
+		__int64 curPosEstimate, curPosInSamples;
+		__int64 lastJumpFrom, lastJumpTo;
+		double ppqEstimate;
+
+		/* samples, numChannels, start, length,
+		octavesBuf, phsBuf, widthBuf, incBuf, octaves, width, phs, shape,
+		octavesSmoothing, phsSmoothing, widthSmoothing */
+		void processSegment(float* const* samples, int numChannels, int start, int length,
+			const float* octavesBuf, const float* phsBuf, const float* widthBuf, const float* incBuf,
+			float octaves, float width, float phs, Shape shape,
+			bool octavesSmoothing, bool phsSmoothing, bool widthSmoothing) noexcept
+		{
+			if (length == 0)
+				return;
+
+			float* const segment[] = { samples[0] + start, samples[numChannels - 1] + start };
+			octavesBuf += start;
+			phsBuf += start;
+			widthBuf += start;
 
 			perlins[perlinIndex]
 			(
-				samples,
-				noise.data(),
+				segment,
+				noises[perlinIndex].data(),
 				gainBuffer.data(),
 				octavesBuf,
 				phsBuf,
 				widthBuf,
+				incBuf == nullptr ? nullptr : incBuf + start,
 				shape,
 				octaves,
 				width,
 				phs,
 				numChannels,
-				numSamples,
-				octavesPRM.smoothing,
-				phsPRM.smoothing,
-				widthPRM.smoothing
+				length,
+				octavesSmoothing,
+				phsSmoothing,
+				widthSmoothing
 			);
 
 			processCrossfade
 			(
-				samples,
+				segment,
 				octavesBuf,
 				phsBuf,
 				widthBuf,
@@ -411,31 +631,80 @@ namespace audio
 				phs,
 				shape,
 				numChannels,
-				numSamples
+				length,
+				octavesSmoothing,
+				phsSmoothing,
+				widthSmoothing
 			);
 		}
-		
-		// misc
-		double sampleRateInv;
-		// noise
-		Perlin::NoiseArray noise;
-		Perlin::GainBuffer gainBuffer;
-		// perlin
-		AudioBuffer prevBuffer;
-		std::array<Perlin, 2> perlins;
-		int perlinIndex;
-		// parameters
-		PRM octavesPRM, widthPRM, phsPRM;
-		double rateBeats, rateHz;
-		double rateInv;
-		// crossfade
-		std::vector<float> xFadeBuffer;
-		float xPhase, xInc;
-		bool crossfading;
-		// seed
-		std::atomic<int> seed;
-		// project position
-		__int64 curPosEstimate, curPosInSamples;
+
+		// NOTE TRIGGERS
+		/* note, retrig */
+		void processTrigger(int note, Retrig retrig) noexcept
+		{
+			auto& perlin = perlins[perlinIndex];
+
+			if (retrig == Retrig::Phase)
+			{
+				perlin.phasor.reset();
+				perlin.noiseIdx = 0;
+			}
+			else if (retrig == Retrig::Reseed)
+			{
+				// only depends on the note, so the same note always restarts the same stretch of noise
+				perlin.phasor.reset();
+				perlin.noiseIdx = (note * ReseedStride) & Perlin::NoiseSizeMax;
+			}
+			else if (retrig == Retrig::Fade)
+			{
+				const auto prevIndex = 1 - perlinIndex;
+				if (crossfading)
+				{
+					// fades out of the current noise again, instead of the one it was fading out of
+					noises[prevIndex] = noises[perlinIndex];
+					perlins[prevIndex].copyPhase(perlin);
+					xPhase = 0.f;
+				}
+				else
+				{
+					if (seedCrossfade)
+					{
+						noises[prevIndex] = noises[perlinIndex];
+						seedCrossfade = false;
+					}
+					initCrossfade();
+				}
+				auto& next = perlins[perlinIndex];
+				next.phasor.reset();
+				next.noiseIdx = 0;
+			}
+		}
+
+		// SEED
+		void processSeed() noexcept
+		{
+			if (crossfading)
+				return;
+
+			if (seedCrossfade)
+			{
+				// the faded out perlin catches up with the new noise
+				noises[1 - perlinIndex] = noises[perlinIndex];
+				seedCrossfade = false;
+			}
+
+			auto expected = SeedStage::Ready;
+			if (!seedStage.compare_exchange_strong(expected, SeedStage::Reading))
+				return;
+
+			const auto nextIndex = 1 - perlinIndex;
+			noises[nextIndex] = seedNoise;
+			seedStage.store(SeedStage::Idle);
+
+			perlins[nextIndex].copyPhase(perlins[perlinIndex]);
+			initCrossfade();
+			seedCrossfade = true;
+		}
 
 		// PROCESS FREE
 		void processFree(const PlayHeadPos& playHeadPos, int numSamples, double _rateHz, bool procedural) noexcept
@@ -464,7 +733,7 @@ namespace audio
 
 				if (playHeadJumps())
 				{
-					shallCrossfade = true;
+					shallCrossfade = !playHeadLoops(playHeadPos, numSamples);
 				}
 				else if (rateHz != _rateHz)
 				{
@@ -483,7 +752,7 @@ namespace audio
 
 			perlins[perlinIndex].updatePosition(playHeadPos, rateHz);
 			
-			processCurPosEstimate(numSamples);
+			processCurPosEstimate(playHeadPos, numSamples);
 		}
 
 		// PROCESS TEMPOSYNC
@@ -523,7 +792,7 @@ namespace audio
 
 				if (playHeadJumps())
 				{
-					shallCrossfade = true;
+					shallCrossfade = !playHeadLoops(playHeadPos, numSamples);
 				}
 				else if (rateBeats != _rateBeats)
 				{
@@ -541,7 +810,30 @@ namespace audio
 
 			perlins[perlinIndex].updatePositionSyncProcedural(playHeadPos, rateInv);
 
-			processCurPosEstimate(numSamples);
+			processCurPosEstimate(playHeadPos, numSamples);
+		}
+
+		// RATE MODULATION
+		/* playHeadPos, rateBuf, numSamples, temposync, procedural
+		returns the per-sample phasor increments or nullptr if not modulated.
+		procedural playback derives its phase from the playhead, so it ignores rate modulation. */
+		const float* processRateMod(const PlayHeadPos& playHeadPos, const float* rateBuf,
+			int numSamples, bool temposync, bool procedural) noexcept
+		{
+			if (rateBuf == nullptr || (procedural && playHeadPos.isPlaying))
+				return nullptr;
+
+			if (!temposync)
+			{
+				SIMD::multiply(incBuffer.data(), rateBuf, static_cast<float>(sampleRateInv), numSamples);
+				return incBuffer.data();
+			}
+
+			const auto bpSamples = playHeadPos.bpm / 60. * sampleRateInv;
+			const auto quarterInc = static_cast<float>(.25 * bpSamples);
+			for (auto s = 0; s < numSamples; ++s)
+				incBuffer[s] = quarterInc / rateBuf[s];
+			return incBuffer.data();
 		}
 
 		// CROSSFADE FUNCS
@@ -551,9 +843,39 @@ namespace audio
 			return distance > 2;
 		}
 
-		void processCurPosEstimate(int numSamples) noexcept
+		/* playHeadPos, numSamples
+		returns true if the jump is the host wrapping around its loop.
+		procedural noise is a function of the position, so a loop can
+		jump straight to the new phase instead of crossfading. */
+		bool playHeadLoops(const PlayHeadPos& playHeadPos, int numSamples) noexcept
+		{
+			auto loops = false;
+
+			if (playHeadPos.isLooping && playHeadPos.ppqLoopEnd > playHeadPos.ppqLoopStart)
+			{
+				const auto ppqTolerance = playHeadPos.bpm / 60. * sampleRateInv * static_cast<double>(numSamples);
+				loops = std::abs(playHeadPos.ppqPosition - playHeadPos.ppqLoopStart) <= ppqTolerance
+					&& std::abs(ppqEstimate - playHeadPos.ppqLoopEnd) <= ppqTolerance;
+			}
+
+			// hosts that don't report their loop points still jump the same way every time
+			if (!loops)
+			{
+				const auto tolerance = static_cast<__int64>(numSamples);
+				loops = std::abs(curPosEstimate - lastJumpFrom) <= tolerance
+					&& std::abs(curPosInSamples - lastJumpTo) <= tolerance;
+			}
+
+			lastJumpFrom = curPosEstimate;
+			lastJumpTo = curPosInSamples;
+			return loops;
+		}
+
+		/* playHeadPos, numSamples */
+		void processCurPosEstimate(const PlayHeadPos& playHeadPos, int numSamples) noexcept
 		{
 			curPosEstimate = curPosInSamples + numSamples;
+			ppqEstimate = playHeadPos.ppqPosition + playHeadPos.bpm / 60. * sampleRateInv * static_cast<double>(numSamples);
 		}
 
 		void initCrossfade() noexcept
@@ -564,32 +886,35 @@ namespace audio
 		}
 
 		/* samples, octavesBuf, phsBuf, widthBuf,
-		octaves, width, phs, numChannels, numSamples */
+		octaves, width, phs, numChannels, numSamples,
+		octavesSmoothing, phsSmoothing, widthSmoothing */
 		void processCrossfade(float* const* samples, const float* octavesBuf,
 			const float* phsBuf, const float* widthBuf,
 			float octaves, float width, float phs, Shape shape,
-			int numChannels, int numSamples) noexcept
+			int numChannels, int numSamples,
+			bool octavesSmoothing, bool phsSmoothing, bool widthSmoothing) noexcept
 		{
 			if (crossfading)
 			{
-				auto prevSamples = prevBuffer.getArrayOfWritePointers();
+				float* const prevSamples[] = { prevBuffer[0].data(), prevBuffer[1].data() };
 				perlins[1 - perlinIndex]
 				(
 					prevSamples,
-					noise.data(),
+					noises[1 - perlinIndex].data(),
 					gainBuffer.data(),
 					octavesBuf,
 					phsBuf,
 					widthBuf,
+					nullptr,
 					shape,
 					octaves,
 					width,
 					phs,
 					numChannels,
 					numSamples,
-					octavesPRM.smoothing,
-					phsPRM.smoothing,
-					widthPRM.smoothing
+					octavesSmoothing,
+					phsSmoothing,
+					widthSmoothing
 					);
 
 				for (auto s = 0; s < numSamples; ++s)
@@ -69,11 +69,8 @@ namespace audio
 
 	void PitchGlitcher::Window::operator()(const float* phasor, int numSamples) noexcept
 	{
-		for (auto s = 0; s < numSamples; ++s)
-		{
-			const auto idx = phasor[s] * tableSizeF;
-			buf[s] = interpolate::lerp(table.data(), idx, TableSize);
-		}
+		SIMD::multiply(buf.data(), phasor, tableSizeF, numSamples);
+		interpolate::block::lerp(buf.data(), table.data(), buf.data(), TableSize, numSamples);
 	}
 
 	const float* PitchGlitcher::Window::data() const noexcept
@@ -161,8 +158,6 @@ namespace audio
 		readHead(),
 		delay(),
 
-		tuneParam(0.f),
-
 		sizeInv(1.f),
 		Fs(0.f)
 	{
@@ -180,13 +175,11 @@ namespace audio
 		delay.prepare(size);
 
 		sizeInv = 1.f / static_cast<float>(size);
-
-		tuneParam.prepare(Fs, blockSize, 70.f);
 	}
 
 	void PitchGlitcher::Shifter::operator()(float* const* samples, int numChannels, int numSamples,
 		const int* wHead, const float* grainBuf,
-		float tune, float feedback) noexcept
+		const float* tuneBuf, float feedback) noexcept
 	{
 		for (auto ch = 0; ch < numChannels; ++ch)
 		{
@@ -196,9 +189,6 @@ namespace audio
 			SIMD::copy(buffer, smpls, numSamples);
 		}
 
-		const auto tuneN = tune * Inv12;
-		const auto tuneBuf = tuneParam(std::pow(2.f, tuneN), numSamples);
-
 		for (auto s = 0; s < numSamples; ++s)
 			phasor.inc[s] = (1.f - tuneBuf[s]) / grainBuf[s];
 
@@ -252,10 +242,14 @@ namespace audio
 
 		shifter(),
 
-		grainParam(20.f),
+		prms(),
 
 		Fs(0.f)
-	{}
+	{
+		prms.addLane(20.f);
+		for (auto i = 0; i < NumVoices; ++i)
+			prms.addLane(0.f);
+	}
 
 	void PitchGlitcher::prepare(float _Fs, int _blockSize)
 	{
@@ -268,7 +262,10 @@ namespace audio
 		for (auto& s : shifter)
 			s.prepare(Fs, _blockSize, size);
 
-		grainParam.prepare(Fs, _blockSize, 140.f);
+		prms.prepare(_blockSize);
+		prms.makeFromDecayInMs(0, 140.f, Fs);
+		for (auto i = 0; i < NumVoices; ++i)
+			prms.makeFromDecayInMs(1 + i, 70.f, Fs);
 	}
 
 	void PitchGlitcher::operator()(float* const* samples, int numChannels, int numSamples,
@@ -277,31 +274,35 @@ namespace audio
 	{
 		wHead(numSamples);
 
-		const auto grainBuf = grainParam(msInSamples(grainSizeP, Fs), numSamples);
+		prms.setDest(0, msInSamples(grainSizeP, Fs));
+		prms.setDest(1, std::pow(2.f, tuneP * Inv12));
+		for (auto i = 1; i < numVoicesP; ++i)
+		{
+			const auto flip = i % 2 == 0 ? 1.f : -1.f;
+			const auto x = static_cast<float>(i) / numVoicesP;
+
+			const auto spreadTune = x * spreadTuneP * flip;
+
+			prms.setDest(1 + i, std::pow(2.f, (tuneP + spreadTune) * Inv12));
+		}
+		prms(numSamples);
+
+		const auto grainBuf = prms[0];
 
 		shifter[0]
 		(
 			samples, numChannels, numSamples,
 			wHead.data(), grainBuf,
-			tuneP, feedbackP
+			prms[1], feedbackP
 			);
 
 		for (auto i = 1; i < numVoicesP; ++i)
-		{
-			auto& shftr = shifter[i];
-
-			const auto flip = i % 2 == 0 ? 1.f : -1.f;
-			const auto x = static_cast<float>(i) / numVoicesP;
-
-			const auto spreadTune = x * spreadTuneP * flip;
-
-			shftr
+			shifter[i]
 			(
 				samples, numChannels, numSamples,
 				wHead.data(), grainBuf,
-				tuneP + spreadTune, feedbackP
+				prms[1 + i], feedbackP
 			);
-		}
 
 		shifter[0].copyTo(samples, numChannels, numSamples);
 		for (auto i = 1; i < numVoicesP; ++i)
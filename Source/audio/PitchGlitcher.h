@@ -97,8 +97,8 @@ namespace audio
 			/* Fs, blockSize, size */
 			void prepare(float, int, int);
 
-			/* samples, numChannels, numSamples, wHead, grainBuf, tune, feedback */
-			void operator()(float* const*, int, int, const int*, const float*, float, float) noexcept;
+			/* samples, numChannels, numSamples, wHead, grainBuf, tuneBuf, feedback */
+			void operator()(float* const*, int, int, const int*, const float*, const float*, float) noexcept;
 
 			/* samples, numChannels, numSamples */
 			void copyTo(float* const*, int, int) noexcept;
@@ -114,8 +114,6 @@ namespace audio
 			ReadHead readHead;
 			Delay delay;
 
-			PRM tuneParam;
-
 			float sizeInv, Fs;
 		};
 
@@ -133,7 +131,8 @@ namespace audio
 		
 		std::array<Shifter, NumVoices> shifter;
 
-		PRM grainParam;
+		// lane 0 is the grain size, the others are the tunes of the voices
+		SmoothBank prms;
 
 		float Fs;
 	};
@@ -0,0 +1,43 @@
+#include "ScratchArena.h"
+#include <cstring>
+
+namespace audio
+{
+	ScratchArena::ScratchArena() :
+		requests(),
+		memory(),
+		footprint(0)
+	{}
+
+	void ScratchArena::begin()
+	{
+		requests.clear();
+		footprint = 0;
+	}
+
+	void ScratchArena::end()
+	{
+		const auto size = footprint + Alignment;
+		if (memory.size() < size)
+			memory.resize(size);
+		std::memset(memory.data(), 0, memory.size());
+
+		const auto address = reinterpret_cast<uintptr_t>(memory.data());
+		const auto misalignment = address % Alignment;
+		const auto start = memory.data() + (misalignment == 0 ? 0 : Alignment - misalignment);
+
+		for (auto& request : requests)
+			request.assign(start + request.offset);
+		requests.clear();
+	}
+
+	size_t ScratchArena::getFootprint() const noexcept
+	{
+		return footprint;
+	}
+
+	size_t ScratchArena::padded(size_t bytes) noexcept
+	{
+		return (bytes + Alignment - 1) / Alignment * Alignment;
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace audio
+{
+	// a view on scratch memory that is owned by a ScratchArena.
+	template<typename T>
+	struct ScratchSpan
+	{
+		ScratchSpan() :
+			ptr(nullptr),
+			num(0)
+		{}
+
+		T* data() noexcept { return ptr; }
+
+		const T* data() const noexcept { return ptr; }
+
+		T& operator[](int i) noexcept { return ptr[i]; }
+
+		const T& operator[](int i) const noexcept { return ptr[i]; }
+
+		int size() const noexcept { return num; }
+
+		T* ptr;
+		int num;
+	};
+
+	/*
+	* hands out the per-block scratch memory of a processor from one allocation.
+	* subsystems request their spans between begin and end, which happens in prepareToPlay.
+	* every span starts on a cache line and is padded to a whole number of cache lines,
+	* so simd loops can safely run over the end of a block.
+	* nothing is allocated outside of end.
+	*/
+	struct ScratchArena
+	{
+		static constexpr size_t Alignment = 64;
+
+		ScratchArena();
+
+		void begin();
+
+		/* span, numElements */
+		template<typename T>
+		void request(ScratchSpan<T>& span, int num)
+		{
+			const auto bytes = padded(sizeof(T) * static_cast<size_t>(num));
+			requests.push_back({ footprint, [&span, num](uint8_t* mem)
+			{
+				span.ptr = reinterpret_cast<T*>(mem);
+				span.num = num;
+			}});
+			footprint += bytes;
+		}
+
+		/* allocates (only if the memory grew) and hands out the requested spans */
+		void end();
+
+		/* the total scratch memory of this instance in bytes */
+		size_t getFootprint() const noexcept;
+
+	protected:
+		struct Request
+		{
+			size_t offset;
+			std::function<void(uint8_t*)> assign;
+		};
+
+		std::vector<Request> requests;
+		std::vector<uint8_t> memory;
+		size_t footprint;
+
+		/* bytes */
+		static size_t padded(size_t) noexcept;
+	};
+}
@@ -0,0 +1,136 @@
+#include "Shaper.h"
+#include "../arch/FormulaParser2.h"
+
+namespace audio
+{
+	namespace
+	{
+		// tries the tables from small to large until one is accurate enough
+		template<int I>
+		void bakeTables(Shaper::Tables& tables, const Shaper::Func& func, float& error, int& sizeIdx)
+		{
+			error = std::get<I>(tables).createShaper(func);
+			sizeIdx = I;
+			if constexpr (I + 1 < Shaper::NumSizes)
+				if (error > Shaper::MaxError)
+					bakeTables<I + 1>(tables, func, error, sizeIdx);
+		}
+
+		template<int I>
+		void shapeTable(const Shaper::Tables& tables, int sizeIdx, float* smpls, int numSamples) noexcept
+		{
+			if (sizeIdx == I)
+				return std::get<I>(tables).shape(smpls, smpls, numSamples);
+			if constexpr (I + 1 < Shaper::NumSizes)
+				shapeTable<I + 1>(tables, sizeIdx, smpls, numSamples);
+		}
+	}
+
+	Shaper::Shaper() :
+		bakes(),
+		worker(),
+		formula(),
+		stage(Stage::Idle),
+		bakeIdx(0)
+	{
+		for (auto& b : bakes)
+		{
+			b = std::make_unique<Bake>();
+			b->error = 0.f;
+			b->sizeIdx = 0;
+			b->enabled = false;
+		}
+	}
+
+	Shaper::~Shaper()
+	{
+		if (worker.joinable())
+			worker.join();
+	}
+
+	void Shaper::savePatch(State& state)
+	{
+		state.set("shaper", "formula", formula, false);
+	}
+
+	void Shaper::loadPatch(State& state)
+	{
+		const auto var = state.get("shaper", "formula");
+		setFormula(var != nullptr ? var->toString() : String());
+	}
+
+	bool Shaper::setFormula(const String& txt)
+	{
+		Func func;
+		if (txt.isNotEmpty())
+		{
+			fx::Parser parser;
+			if (!parser(txt))
+				return false;
+			func = [parser](float x) { return parser(x); };
+		}
+		formula = txt;
+
+		if (worker.joinable())
+			worker.join();
+		worker = std::thread([this, f = std::move(func)]()
+		{
+			bake(f);
+		});
+		return true;
+	}
+
+	const String& Shaper::getFormula() const noexcept
+	{
+		return formula;
+	}
+
+	void Shaper::operator()(float* const* samples, int numChannels, int numSamples) noexcept
+	{
+		processBake();
+
+		const auto& b = *bakes[bakeIdx.load()];
+		if (!b.enabled)
+			return;
+
+		for (auto ch = 0; ch < numChannels; ++ch)
+		{
+			auto smpls = samples[ch];
+			shapeTable<0>(b.tables, b.sizeIdx, smpls, numSamples);
+			SIMD::clip(smpls, smpls, -1.f, 1.f, numSamples);
+		}
+	}
+
+	void Shaper::bake(const Func& func)
+	{
+		// only one bake writes at a time and the audio thread doesn't swap meanwhile.
+		// a pending bake (Ready) hasn't been swapped in yet, so it can be overwritten
+		while (true)
+		{
+			auto expected = Stage::Idle;
+			if (stage.compare_exchange_weak(expected, Stage::Writing))
+				break;
+			expected = Stage::Ready;
+			if (stage.compare_exchange_weak(expected, Stage::Writing))
+				break;
+			std::this_thread::yield();
+		}
+
+		auto& b = *bakes[1 - bakeIdx.load()];
+		b.enabled = func != nullptr;
+		if (b.enabled)
+			bakeTables<0>(b.tables, func, b.error, b.sizeIdx);
+
+		stage.store(Stage::Ready);
+	}
+
+	void Shaper::processBake() noexcept
+	{
+		// the index flips before the stage is released, so a new bake writes the other table
+		auto expected = Stage::Ready;
+		if (!stage.compare_exchange_strong(expected, Stage::Swapping))
+			return;
+		bakeIdx.store(1 - bakeIdx.load());
+		stage.store(Stage::Idle);
+	}
+}
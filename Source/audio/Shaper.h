@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include "WaveTable.h"
+
+namespace audio
+{
+	/*
+	* shapes the perlin output with a user formula f(x), x in [-1, 1].
+	* the formula is baked into a wavetable on a background thread.
+	* the smallest table whose interpolation stays within MaxError of the formula is used,
+	* so the audio thread only does one table read per sample, no matter the formula.
+	* a new table is picked up at the start of the next block.
+	*/
+	struct Shaper
+	{
+		static constexpr float MaxError = .0001f;
+
+		using Tables = std::tuple<WaveTable<1 << 8>, WaveTable<1 << 9>, WaveTable<1 << 10>,
+			WaveTable<1 << 11>, WaveTable<1 << 12>, WaveTable<1 << 13>>;
+		using Func = std::function<float(float)>;
+
+		static constexpr int NumSizes = static_cast<int>(std::tuple_size<Tables>::value);
+
+		Shaper();
+
+		~Shaper();
+
+		/* state */
+		void savePatch(State&);
+
+		/* state */
+		void loadPatch(State&);
+
+		/* formula, returns false if it can't be parsed. an empty formula disables the shaper */
+		bool setFormula(const String&);
+
+		const String& getFormula() const noexcept;
+
+		/* samples, numChannels, numSamples */
+		void operator()(float* const*, int, int) noexcept;
+
+	protected:
+		// Swapping: the audio thread flips bakeIdx, nothing may write meanwhile
+		enum class Stage { Idle, Writing, Ready, Swapping };
+
+		struct Bake
+		{
+			Tables tables;
+			float error;
+			int sizeIdx;
+			bool enabled;
+		};
+
+		std::array<std::unique_ptr<Bake>, 2> bakes;
+		std::thread worker;
+		String formula;
+		std::atomic<Stage> stage;
+		std::atomic<int> bakeIdx;
+
+		/* func, nullptr disables the shaper */
+		void bake(const Func&);
+
+		void processBake() noexcept;
+	};
+}
@@ -21,6 +21,26 @@ namespace audio
 			table[Size + i] = table[i];
 	}
 
+	template<size_t Size>
+	float WaveTable<Size>::createShaper(const Func& func) noexcept
+	{
+		const auto inc = 2.f * SizeInv;
+		for (auto s = 0; s <= Size; ++s)
+			table[s] = func(-1.f + static_cast<float>(s) * inc);
+		for (auto i = Size + 1; i < FullSize; ++i)
+			table[i] = table[Size];
+
+		// the deviation of linear interpolation peaks between the points
+		auto maxError = 0.f;
+		for (auto s = 0; s < Size; ++s)
+		{
+			const auto x = -1.f + (static_cast<float>(s) + .5f) * inc;
+			const auto y = .5f * (table[s] + table[s + 1]);
+			maxError = std::max(maxError, std::abs(func(x) - y));
+		}
+		return maxError;
+	}
+
 	template<size_t Size>
 	void WaveTable<Size>::savePatch(sta::State& state, const String& key)
 	{
@@ -62,6 +82,23 @@ namespace audio
 		return interpolate::lerp(table.data(), idx);
 	}
 
+	template<size_t Size>
+	void WaveTable<Size>::operator()(float* dest, const float* phase, int numSamples) const noexcept
+	{
+		SIMD::multiply(dest, phase, SizeF, numSamples);
+		interpolate::block::lerp(dest, table.data(), dest, numSamples);
+	}
+
+	template<size_t Size>
+	void WaveTable<Size>::shape(float* dest, const float* samples, int numSamples) const noexcept
+	{
+		const auto halfSize = .5f * SizeF;
+		SIMD::clip(dest, samples, -1.f, 1.f, numSamples);
+		SIMD::multiply(dest, halfSize, numSamples);
+		SIMD::add(dest, halfSize, numSamples);
+		interpolate::block::lerp(dest, table.data(), dest, numSamples);
+	}
+
 	template<size_t Size>
 	float* WaveTable<Size>::data() noexcept
 	{
@@ -21,6 +21,10 @@ namespace audio
 
 		void create(const Func&) noexcept;
 
+		/* func, returns the max deviation of the interpolated table from func.
+		the shaper layout spans [-1, 1] including both ends and doesn't wrap */
+		float createShaper(const Func&) noexcept;
+
 		/* state, key*/
 		void savePatch(sta::State&, const String&);
 
@@ -33,6 +37,12 @@ namespace audio
 		/* phase */
 		float operator()(float) const noexcept;
 
+		/* dest, phase, numSamples. dest may be the phase buffer */
+		void operator()(float*, const float*, int) const noexcept;
+
+		/* dest, samples [-1, 1], numSamples. needs the shaper layout. dest may be samples */
+		void shape(float*, const float*, int) const noexcept;
+
 		float* data() noexcept;
 
 		const float* data() const noexcept;
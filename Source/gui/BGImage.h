@@ -262,7 +262,10 @@ namespace gui
         Random rand;
         
         audio::Perlin2 perlin;
-        perlin.prepare(widthF, width);
+        audio::ScratchArena arena;
+        arena.begin();
+        perlin.prepare(widthF, width, arena);
+        arena.end();
 
         auto octaves = 1.f + rand.nextFloat() * 6.f;
 
@@ -275,7 +278,7 @@ namespace gui
             
             const auto rateHz = 2. + iR * 13.;
             
-            perlin.setSeed(rand.nextInt());
+            perlin.setSeed(rand.nextInt(), false);
             perlin
             (
                 samples,
@@ -289,7 +292,11 @@ namespace gui
                 0.f,
                 static_cast<audio::Perlin::Shape>(std::abs(rand.nextInt()) % 3),
                 false,
-                false
+                false,
+                audio::Perlin2::ModBuffers(),
+                nullptr,
+                0,
+                audio::Perlin2::Retrig::Off
             );
             
             const auto brightness = .12f + iR * .2f;
@@ -166,7 +166,7 @@ namespace gui
 
 		initLockButton();
 
-		startTimerHz(24);
+		utils.getScheduler().add(*this, [this]() { timerCallback(); }, { pID[0] });
 	}
 
 	Button::Button(Utils& _utils, String&& _tooltip, Notify&& _notify) :
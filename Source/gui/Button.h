@@ -39,7 +39,7 @@ namespace gui
 		void enableParameter(const std::vector<PID>&);
 
 		/* utils, tooltip, notify */
-		Button(Utils&, String&& = "", Notify&& = [](EvtType, const void*){});
+		Button(Utils&, String&& = "", Notify&& = Notify());
 
 		Label& getLabel() noexcept;
 
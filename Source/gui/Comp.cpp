@@ -16,6 +16,14 @@ namespace gui
 		setInterceptsMouseClicks(false, true);
 	}
 
+	Comp::~Comp()
+	{
+		utils.getScheduler().remove(*this);
+		auto& eventSystem = utils.getEventSystem();
+		eventSystem.discard(this);
+		eventSystem.discard(&tooltip);
+	}
+
 	Comp::Comp(Utils& _utils, const String& _tooltip, Notify&& _notify, CursorType _cursorType) :
 		utils(_utils),
 		layout(*this),
@@ -92,7 +100,7 @@ namespace gui
 
 	Notify Comp::makeNotifyBasic(Comp* c)
 	{
-		return[&comp = *c](const EvtType type, const void*)
+		return Notify({ EvtType::ColourSchemeChanged, EvtType::PatchUpdated }, [&comp = *c](const EvtType type, const void*)
 		{
 			if (type == EvtType::ColourSchemeChanged)
 			{
@@ -104,7 +112,7 @@ namespace gui
 				comp.resized();
 				comp.repaint();
 			}
-		};
+		});
 	}
 
 	////////////////////////////////////
@@ -14,6 +14,8 @@ namespace gui
 		/* utils, tooltip, notify, cursorType */
 		Comp(Utils&, const String&, Notify&&, CursorType = CursorType::Interact);
 
+		~Comp() override;
+
 		const Utils& getUtils() const noexcept;
 		Utils& getUtils() noexcept;
 
@@ -63,7 +65,7 @@ namespace gui
 		
 		/* utils, tooltip, notify, cursorType */
 		CompWidgetable(Utils&, String&&,
-			Notify&& = [](EvtType, const void*) {}, CursorType = CursorType::Interact);
+			Notify&& = Notify(), CursorType = CursorType::Interact);
 
 		void defineBounds(const BoundsF&, const BoundsF&);
 
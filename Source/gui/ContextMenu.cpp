@@ -4,7 +4,7 @@ namespace gui
 {
 	Notify ContextMenu::makeNotify(ContextMenu& popUp)
 	{
-		return [&pop = popUp](EvtType type, const void*)
+		return Notify({ EvtType::ClickedEmpty, EvtType::ParametrDragged, EvtType::EnterParametrValue }, [&pop = popUp](EvtType type, const void*)
 		{
 			if (type == EvtType::ClickedEmpty ||
 				type == EvtType::ParametrDragged ||
@@ -12,7 +12,7 @@ namespace gui
 			{
 				pop.setVisible(false);
 			}
-		};
+		});
 	}
 
 	ContextMenu::ContextMenu(Utils& u) :
@@ -102,7 +102,7 @@ namespace gui
 
 	Notify ContextMenuButtons::makeNotify2(ContextMenuButtons& popUp)
 	{
-		return [&pop = popUp](EvtType type, const void* stuff)
+		return Notify({ EvtType::ButtonRightClicked }, [&pop = popUp](EvtType type, const void* stuff)
 		{
 			if (type == EvtType::ButtonRightClicked)
 			{
@@ -170,7 +170,7 @@ namespace gui
 
 				pop.place(&button);
 			}
-		};
+		});
 	}
 
 	ContextMenuButtons::ContextMenuButtons(Utils& u) :
@@ -194,7 +194,7 @@ namespace gui
 
 	Notify ContextMenuMacro::makeNotify2(ContextMenuMacro& popUp)
 	{
-		return [&pop = popUp](EvtType type, const void* stuff)
+		return Notify({ EvtType::ButtonRightClicked }, [&pop = popUp](EvtType type, const void* stuff)
 		{
 			if (type == EvtType::ButtonRightClicked)
 			{
@@ -231,7 +231,7 @@ namespace gui
 
 				pop.place(&button);
 			}
-		};
+		});
 	}
 
 	ContextMenuMacro::ContextMenuMacro(Utils& u) :
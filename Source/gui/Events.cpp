@@ -2,24 +2,44 @@
 
 namespace evt
 {
+    //NOTIFY
+
+    Notify::Notify() :
+        callback(nullptr),
+        types(0)
+    {}
+
+    Notify::Notify(std::initializer_list<Type> _types, Callback&& _callback) :
+        callback(std::move(_callback)),
+        types(0)
+    {
+        for (const auto type : _types)
+            types |= toMask(type);
+    }
+
+    void Notify::operator()(const Type type, const void* stuff) const
+    {
+        callback(type, stuff);
+    }
+
     //SYSTEM::EVT
 
     System::Evt::Evt(System& _sys) :
-        sys(_sys),
-        notifier(nullptr)
+        notifier(),
+        sys(_sys)
     {
     }
 
     System::Evt::Evt(System& _sys, const Notify& _notifier) :
-        sys(_sys),
-        notifier(_notifier)
+        notifier(_notifier),
+        sys(_sys)
     {
         sys.add(this);
     }
 
     System::Evt::Evt(System& _sys, Notify&& _notifier) :
-        sys(_sys),
-        notifier(_notifier)
+        notifier(std::move(_notifier)),
+        sys(_sys)
     {
         sys.add(this);
     }
@@ -44,28 +64,75 @@ namespace evt
     //SYSTEM
 
     System::System() :
-        evts()
-    {}
+        evts(),
+        pendingStuff(),
+        pending(0)
+    {
+        pendingStuff.fill(nullptr);
+    }
 
     void System::notify(const Type type, const void* stuff)
     {
-        for (const auto e : evts)
-            e->notifier(type, stuff);
+        const auto mask = toMask(type);
+        if (DeferredTypes & mask)
+        {
+            // only the latest one matters
+            pendingStuff[static_cast<int>(type)] = stuff;
+            pending |= mask;
+            return;
+        }
+        deliver(type, stuff);
+    }
+
+    void System::flush()
+    {
+        for (auto t = 0; t < NumTypes && pending != 0; ++t)
+        {
+            const auto type = static_cast<Type>(t);
+            const auto mask = toMask(type);
+            if (pending & mask)
+            {
+                pending &= ~mask;
+                deliver(type, pendingStuff[t]);
+            }
+        }
+    }
+
+    void System::discard(const void* stuff) noexcept
+    {
+        for (auto t = 0; t < NumTypes; ++t)
+            if (pendingStuff[t] == stuff)
+                pending &= ~toMask(static_cast<Type>(t));
+    }
+
+    void System::deliver(const Type type, const void* stuff)
+    {
+        // listeners can be added from a callback, so no references are kept across calls
+        const auto& list = evts[static_cast<int>(type)];
+        for (auto i = 0; i < list.size(); ++i)
+            list[i]->notifier(type, stuff);
     }
 
     void System::add(Evt* e)
     {
-        evts.push_back(e);
+        for (auto t = 0; t < NumTypes; ++t)
+            if (e->notifier.types & toMask(static_cast<Type>(t)))
+                evts[t].push_back(e);
     }
 
     void System::remove(const Evt* e)
     {
-        for (auto i = 0; i < evts.size(); ++i)
-            if (e == evts[i])
-            {
-                evts.erase(evts.begin() + i);
-                return;
-            }
+        for (auto t = 0; t < NumTypes; ++t)
+        {
+            if (!(e->notifier.types & toMask(static_cast<Type>(t))))
+                continue;
+            auto& list = evts[t];
+            for (auto i = 0; i < list.size(); ++i)
+                if (e == list[i])
+                {
+                    list.erase(list.begin() + i);
+                    break;
+                }
+        }
     }
 }
-
@@ -1,6 +1,9 @@
 #pragma once
 #include <vector>
+#include <array>
 #include <functional>
+#include <initializer_list>
+#include <type_traits>
 
 namespace evt
 {
@@ -23,7 +26,48 @@ namespace evt
         NumTypes
     };
 
-    using Notify = std::function<void(const Type, const void*)>;
+    static constexpr int NumTypes = static_cast<int>(Type::NumTypes);
+
+    // one bit per type
+    using Mask = unsigned int;
+
+    /* type */
+    constexpr Mask toMask(Type type) noexcept
+    {
+        return 1u << static_cast<unsigned int>(type);
+    }
+
+    static constexpr Mask AllTypes = (1u << NumTypes) - 1u;
+
+    // high-frequency events are coalesced and delivered once per frame
+    static constexpr Mask DeferredTypes = toMask(Type::TooltipUpdated) | toMask(Type::ParametrDragged);
+
+    using Callback = std::function<void(const Type, const void*)>;
+
+    /*
+    * a callback and the types it subscribes to.
+    * a plain callback subscribes to all types, so it should be given the types it handles.
+    */
+    struct Notify
+    {
+        // subscribes to nothing
+        Notify();
+
+        /* types, callback */
+        Notify(std::initializer_list<Type>, Callback&&);
+
+        template<typename Func, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Func>, Notify>>>
+        Notify(Func&& func) :
+            callback(std::forward<Func>(func)),
+            types(AllTypes)
+        {}
+
+        /* type, stuff */
+        void operator()(const Type, const void*) const;
+
+        Callback callback;
+        Mask types;
+    };
 
 	struct System
 	{
@@ -48,13 +92,25 @@ namespace evt
 
         System();
 
+        /* type, stuff. deferred types are only delivered on the next flush */
         void notify(const Type, const void* = nullptr);
 
+        // delivers the latest of each pending deferred event
+        void flush();
+
+        /* stuff, drops the pending events that point to it (call this before it's destroyed) */
+        void discard(const void*) noexcept;
+
     protected:
-		std::vector<Evt*> evts;
+		std::array<std::vector<Evt*>, NumTypes> evts;
+        std::array<const void*, NumTypes> pendingStuff;
+        Mask pending;
+
+        /* type, stuff */
+        void deliver(const Type, const void*);
 
         void add(Evt*);
         
         void remove(const Evt*);
 	};
-}
\ No newline at end of file
+}
@@ -25,7 +25,8 @@ namespace gui
 				auto x = -1.f;
 				const auto inc = 2.f / static_cast<float>(size);
 				for (auto i = 0; i < size; ++i, x += inc)
-					tables[0][i] = fx(x);
+					tables[0][i] = x;
+				fx(tables[0], tables[0], size);
 			}
 
 			const auto sizeInv = 1.f / static_cast<float>(size);
@@ -79,6 +80,22 @@ namespace gui
 		multiLine = false;
 	}
 
+	FormulaParser::FormulaParser(Utils& u, String&& _tooltip) :
+		TextEditor(u, _tooltip, "enter some math"),
+		postFX{ false, false, false },
+		fx(),
+		updateFormula([]() {})
+	{
+		onReturn = [this]()
+		{
+			return fx(txt);
+		};
+
+		setInterceptsMouseClicks(true, true);
+
+		multiLine = false;
+	}
+
 	// FormulaParser2
 
 	FormulaParser2::FormulaParser2(Utils& u, String&& _tooltip, std::vector<float*>& tables, int size, int overshoot) :
@@ -119,7 +136,6 @@ namespace gui
 				if (user != nullptr)
 				{
 					user->setValue("Parser_DCOffset", dc.toggleState);
-					user->save();
 				}
 			});
 		normalize.onClick.push_back([&](Button& btn, const Mouse&)
@@ -130,7 +146,6 @@ namespace gui
 				if (user != nullptr)
 				{
 					user->setValue("Parser_Normalize", normalize.toggleState);
-					user->save();
 				}
 			});
 		windowing.onClick.push_back([&](Button& btn, const Mouse&)
@@ -141,7 +156,6 @@ namespace gui
 				if (user != nullptr)
 				{
 					user->setValue("Parser_Windowing", windowing.toggleState);
-					user->save();
 				}
 			});
 		random.onClick.push_back([&](Button&, const Mouse&)
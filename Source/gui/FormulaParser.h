@@ -20,6 +20,9 @@ namespace gui
 		/* utils, tooltip, tables, table size, table overshoot length */
 		FormulaParser(Utils&, String&&, std::vector<float*>&, int, int = 0);
 
+		/* utils, tooltip. only parses, onReturn decides what the formula is used for */
+		FormulaParser(Utils&, String&&);
+
 		/* samples */
 		std::array<bool, NumPostFX> postFX;
 		Parser fx;
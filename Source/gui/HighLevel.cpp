@@ -4,7 +4,7 @@ namespace gui
 {
 	Notify HighLevel::makeNotify(HighLevel& hl)
 	{
-		return [&highLevel = hl](EvtType t, const void*)
+		return Notify({ EvtType::ClickedEmpty }, [&highLevel = hl](EvtType t, const void*)
 		{
 			if (t == EvtType::ClickedEmpty)
 			{
@@ -23,7 +23,7 @@ namespace gui
 				highLevel.patchBrowserButton.repaint();
 #endif
 			}
-		};
+		});
 	}
 
 	HighLevel::HighLevel(Utils& u, LowLevel* _lowLevel
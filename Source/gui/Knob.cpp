@@ -1073,7 +1073,11 @@ namespace gui
             }
         }
 
-        knob.startTimerHz(PPDFPSKnobs);
+        // a meter changes all the time, everything else only with its param
+        if (meter != nullptr)
+            utils.getScheduler().add(knob, [&knob]() { knob.timerCallback(); }, static_cast<float>(PPDFPSKnobs));
+        else
+            utils.getScheduler().add(knob, [&knob]() { knob.timerCallback(); }, { mainPID });
     }
 
     void makeParameter(Knob& knob, PID pIDHorizontal, PID pIDVertical)
@@ -1310,14 +1314,14 @@ namespace gui
 
         knob.comps.reserve(looks::NumComps);
 
-        knob.startTimerHz(PPDFPSKnobs);
+        utils.getScheduler().add(knob, [&knob]() { knob.timerCallback(); }, { mainPID });
     }
 	
     // CONTEXT MENU
 
     Notify ContextMenuKnobs::makeNotify2(ContextMenuKnobs& popUp)
     {
-        return [&pop = popUp](EvtType type, const void* stuff)
+        return Notify({ EvtType::ParametrRightClicked }, [&pop = popUp](EvtType type, const void* stuff)
         {
             if (type == EvtType::ParametrRightClicked)
             {
@@ -1383,7 +1387,7 @@ namespace gui
 
                 pop.place(&knob);
             }
-        };
+        });
     }
 
     ContextMenuKnobs::ContextMenuKnobs(Utils& u) :
@@ -1408,7 +1412,7 @@ namespace gui
 
     Notify TextEditorKnobs::makeNotify(TextEditorKnobs& tek)
     {
-        return [&editor = tek](EvtType type, const void* stuff)
+        return Notify({ EvtType::ClickedEmpty, EvtType::EnterParametrValue }, [&editor = tek](EvtType type, const void* stuff)
         {
             if (type == EvtType::ClickedEmpty)
             {
@@ -1471,7 +1475,7 @@ namespace gui
                 editor.setCentrePosition(parametrPos + parametrCentre);
                 editor.enable();
             }
-        };
+        });
     }
 
     TextEditorKnobs::TextEditorKnobs(Utils& u) :
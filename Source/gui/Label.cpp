@@ -10,7 +10,15 @@ namespace gui
 		font(getFontDosisExtraBold()),
 		minFontHeight(12.f),
 		mode(Mode::WindowToTextBounds),
-		text(_text)
+		text(_text),
+		glyphs(),
+		glyphsText(),
+		glyphsFont(font),
+		glyphsJust(just),
+		glyphsBounds(),
+		measuredBounds(),
+		measuredText(),
+		measuredFont(font)
 	{
 		font.setHeight(minFontHeight);
 		setInterceptsMouseClicks(false, false);
@@ -45,12 +53,48 @@ namespace gui
 		return text.isEmpty();
 	}
 
+	BoundsF Label::getTextBounds()
+	{
+		auto f = font;
+		f.setHeight(measuredFont.getHeight());
+		if (text != measuredText || f != measuredFont)
+		{
+			measuredText = text;
+			measuredFont = font;
+			measuredBounds = boundsOf(font, text);
+			return measuredBounds;
+		}
+
+		const auto scale = font.getHeight() / measuredFont.getHeight();
+		return { 0.f, 0.f, measuredBounds.getWidth() * scale, measuredBounds.getHeight() * scale };
+	}
+
+	void Label::updateGlyphs()
+	{
+		const auto bounds = getLocalBounds();
+		if (text == glyphsText && font == glyphsFont && just == glyphsJust && bounds == glyphsBounds)
+			return;
+
+		glyphsText = text;
+		glyphsFont = font;
+		glyphsJust = just;
+		glyphsBounds = bounds;
+
+		glyphs.clear();
+		glyphs.addFittedText(font, text,
+			static_cast<float>(bounds.getX()), static_cast<float>(bounds.getY()),
+			static_cast<float>(bounds.getWidth()), static_cast<float>(bounds.getHeight()),
+			just, 1);
+	}
+
 	void Label::paint(Graphics& g)
 	{
-		const auto bounds = getLocalBounds().toFloat();
+		if (empty() || getWidth() == 0 || getHeight() == 0)
+			return;
+
+		updateGlyphs();
 		g.setColour(Colours::c(textCID));
-		g.setFont(font);
-		g.drawFittedText(text, bounds.toNearestInt(), just, 1);
+		glyphs.draw(g);
 	}
 
 	void Label::resized()
@@ -75,7 +119,7 @@ namespace gui
 			const auto width = static_cast<float>(getWidth());
 			const auto height = static_cast<float>(getHeight());
 			
-			const auto fontBounds = boundsOf(font, text);
+			const auto fontBounds = getTextBounds();
 			
 			if (fontBounds.getWidth() != 0.f)
 			{
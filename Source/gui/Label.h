@@ -15,7 +15,7 @@ namespace gui
 		};
 
 		/* utils, text, notify */
-		Label(Utils&, const String&, Notify && = [](EvtType, const void*) {});
+		Label(Utils&, const String&, Notify&& = Notify());
 
 		void setText(const String&);
 
@@ -35,6 +35,21 @@ namespace gui
 		void updateTextBounds();
 	protected:
 		String text;
+		// the glyphs of the last paint, only laid out again if text, font, just or bounds changed
+		GlyphArrangement glyphs;
+		String glyphsText;
+		Font glyphsFont;
+		Just glyphsJust;
+		Bounds glyphsBounds;
+		// the text's bounds at measuredFont's height, they scale with the font height
+		BoundsF measuredBounds;
+		String measuredText;
+		Font measuredFont;
+
+		/* returns the bounds of text with font */
+		BoundsF getTextBounds();
+
+		void updateGlyphs();
 
 		void paint(Graphics&) override;
 
@@ -1,6 +1,7 @@
 #pragma once
 #include "Knob.h"
 #include "Oscilloscope.h"
+#include "FormulaParser.h"
 
 namespace gui
 {
@@ -24,6 +25,7 @@ namespace gui
             orientation(u),
             randType(u),
 			outputType(u),
+            shaper(u, "Shape the perlin noise with a formula of x [-1, 1]. Leave it empty to bypass the shaper."),
             scopeL(u, "", u.audioProcessor.scope[0]),
 			scopeR(u, "", u.audioProcessor.scope[1])
         {
@@ -102,7 +104,7 @@ namespace gui
                                 button->repaint();
 					});
 
-                    buttons[i]->startTimerHz(12);
+                    u.getScheduler().add(*buttons[i], [b = buttons[i]]() { b->timerCallback(); }, { PID::Shape });
                 }
                     
             }
@@ -122,6 +124,13 @@ namespace gui
 			makeParameter(outputType, PID::OutputType, "CC", true);
 			addAndMakeVisible(outputType);
 
+            shaper.setText(u.audioProcessor.shaper.getFormula());
+            shaper.onReturn = [this]()
+            {
+                return utils.audioProcessor.shaper.setFormula(shaper.getText());
+            };
+            addAndMakeVisible(shaper);
+
             seed.onClick.push_back([](Button& btn, const Mouse&)
             {
                 auto& u = btn.utils;
@@ -137,7 +146,7 @@ namespace gui
                 { 8, 5, 3, 21 } // visualizers, radiobuttons; seed+knobs; knobs
             );
 
-            startTimerHz(24);
+            u.getScheduler().add(*this, [this]() { timerCallback(); }, { PID::RateType });
         }
 
         void paint(Graphics& g) override
@@ -185,6 +194,7 @@ namespace gui
 				width.setBounds(BoundsF(x, area.getY(), knobW, area.getHeight()).toNearestInt());
             }
             layout.place(seed, 1, 1, 1, 1);
+            layout.place(shaper, 2, 1, 1, 1);
             {
                 const auto area = layout(1, 2, 1, 1);
                 const auto w = area.getWidth();
@@ -224,6 +234,7 @@ namespace gui
         Knob rateHz, rateBeats, oct, width, phase;
         Button shapeNN, shapeLin, shapeRound;
         Button rateType, seed, orientation, randType, outputType;
+        FormulaParser shaper;
         Oscilloscope scopeL, scopeR;
     };
 }
\ No newline at end of file
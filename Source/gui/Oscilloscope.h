@@ -4,22 +4,37 @@
 
 namespace gui
 {
+	/*
+	* draws the scope incrementally.
+	* the centre line is cached in a background image and the curve lives in an offscreen image.
+	* on every published frame only the points between the last and the current write position
+	* are redrawn into the curve image, and only their columns are repainted.
+	* the images have the display's resolution and are drawn into in logical coordinates.
+	*/
 	struct Oscilloscope :
 		public Comp,
 		public Timer
 	{
 		using Oscope = audio::Oscilloscope;
+		using Frame = Oscope::Frame;
 		static constexpr int FPS = 24;
 
-		Oscilloscope(Utils& u, String&& _tooltip, const Oscope& _oscope) :
+		Oscilloscope(Utils& u, String&& _tooltip, Oscope& _oscope) :
 			Comp(u, _tooltip, CursorType::Default),
 			Timer(),
 			lineCID(ColourID::Txt),
 			oscope(_oscope),
+			bounds(),
+			bgImage(),
+			curveImage(),
 			curve(),
+			scale(1.f),
+			lastBeatLength(0.f),
+			lastSequence(0),
+			lastPoint(-1),
 			bipolar(true)
 		{
-			startTimerHz(FPS);
+			u.getScheduler().add(*this, [this]() { timerCallback(); }, static_cast<float>(FPS));
 		}
 
 		void resized() override
@@ -28,88 +43,183 @@ namespace gui
 			bounds = getLocalBounds().toFloat().reduced(thicc);
 
 			curve = Path();
-			curve.preallocateSpace(static_cast<int>(bounds.getWidth() / thicc) + 1);
+			curve.preallocateSpace(3 * (static_cast<int>(bounds.getWidth() / thicc) + 2));
+
+			scale = Component::getApproximateScaleFactorForComponent(this);
+			const auto width = std::max(1, static_cast<int>(std::ceil(static_cast<float>(getWidth()) * scale)));
+			const auto height = std::max(1, static_cast<int>(std::ceil(static_cast<float>(getHeight()) * scale)));
+			bgImage = Image(Image::ARGB, width, height, true);
+			if (bipolar)
+			{
+				Graphics g(bgImage);
+				g.addTransform(juce::AffineTransform::scale(scale));
+				g.setColour(Colours::c(ColourID::Hover));
+				const auto y = static_cast<int>(bounds.getY() + bounds.getHeight() * .5f);
+				const auto inc = static_cast<int>(thicc * 3.f);
+				for (auto x = static_cast<int>(bounds.getX()); x < bounds.getRight(); x += inc)
+					g.fillRect(x, y, 1, 1);
+			}
+
+			curveImage = Image(Image::ARGB, width, height, true);
+			// forces a full redraw on the next tick
+			lastBeatLength = 0.f;
+			lastSequence = oscope.getSequence() - 1;
+			lastPoint = -1;
 		}
 
 		void paint(Graphics& g) override
 		{
-			curve.clear();
-			const auto thicc = utils.thicc;
-			
-			const auto data = oscope.data();
-			const auto size = oscope.windowLength();
-			const auto sizeF = static_cast<float>(size);
-			const auto beatLength = oscope.getBeatLength();
-			const auto w = bounds.getWidth();
-			const auto h = bounds.getHeight();
-			const auto xScale = w / std::min(beatLength, sizeF);
-			const auto xScaleInv = 1.f / xScale;
-			const auto xOff = bounds.getX();
-			
-			if (!bipolar)
+			const auto toLogical = juce::AffineTransform::scale(1.f / scale);
+			g.drawImageTransformed(bgImage, toLogical);
+			g.drawImageTransformed(curveImage, toLogical);
+		}
+
+		void timerCallback() override
+		{
+			// moved to a display with another scale
+			if (scale != Component::getApproximateScaleFactorForComponent(this))
+				resized();
+
+			const auto sequence = oscope.getSequence();
+			if (sequence == lastSequence || curveImage.isNull())
+				return;
+			lastSequence = sequence;
+
+			const auto& frame = oscope.read();
+			const auto numPoints = getNumPoints();
+			const auto barBins = getBarBins(frame);
+			const auto curPoint = juce::jlimit(0, numPoints - 1,
+				static_cast<int>(static_cast<float>(frame.writeBin) * static_cast<float>(numPoints) / barBins));
+
+			// a new bar length or a fresh image remaps every point
+			if (frame.beatLength != lastBeatLength || lastPoint < 0)
 			{
-				auto value = data[0];
-				auto y = h - value * h;
-				curve.startNewSubPath(xOff, y);
-				for (auto i = 1.f; i <= w; i += thicc)
-				{
-					const auto x = xOff + i;
-					const auto idx = static_cast<int>(i * xScaleInv);
-					value = data[idx];
-					y = h - value * h;
-					curve.lineTo(x, y);
-				}
+				lastBeatLength = frame.beatLength;
+				lastPoint = curPoint;
+				updatePoints(frame, 0, numPoints - 1);
+				return repaint();
 			}
+
+			if (curPoint >= lastPoint)
+				updatePoints(frame, lastPoint, curPoint);
 			else
 			{
-				const auto heightHalf = h * .5f;
-				const auto centreY = bounds.getY() + heightHalf;
-				
-				{
-					g.setColour(Colours::c(ColourID::Hover));
-					const auto y = static_cast<int>(centreY);
-					const auto inc = static_cast<int>(thicc * 3.f);
-					for (auto x = static_cast<int>(bounds.getX()); x < bounds.getRight(); x += inc)
-						g.fillRect(x,y,1,1);
-				}
-
-				auto value = data[0];
-				auto y = centreY - value * heightHalf;
-				curve.startNewSubPath(xOff, y);
-				for (auto i = 1.f; i <= w; i += thicc)
-				{
-					const auto x = xOff + i;
-					const auto idx = static_cast<int>(i * xScaleInv);
-					value = data[idx];
-					y = centreY - value * heightHalf;
-					curve.lineTo(x, y);
-				}
+				updatePoints(frame, lastPoint, numPoints - 1);
+				updatePoints(frame, 0, curPoint);
 			}
-			
-			Stroke stroke(thicc, Stroke::JointStyle::beveled, Stroke::EndCapStyle::rounded);
-			g.setColour(Colours::c(lineCID));
-			g.strokePath(curve, stroke);
-		}
-
-		void timerCallback() override
-		{
-			repaint();
+			lastPoint = curPoint;
 		}
 
 		ColourID lineCID;
 	protected:
-		const Oscope& oscope;
+		Oscope& oscope;
 		BoundsF bounds;
+		Image bgImage, curveImage;
 		Path curve;
+		float scale, lastBeatLength;
+		unsigned int lastSequence;
+		int lastPoint;
 	public:
 		bool bipolar;
-	};
-}
+	protected:
+		int getNumPoints() const noexcept
+		{
+			return std::max(1, static_cast<int>(bounds.getWidth() / utils.thicc));
+		}
 
-/*
+		/* frame, returns the number of level 0 bins in one bar */
+		float getBarBins(const Frame& frame) const noexcept
+		{
+			return juce::jlimit(1.f, static_cast<float>(Oscope::NumBins), frame.beatLength / frame.samplesPerBin);
+		}
 
-todo:
+		float getX(int p) const noexcept
+		{
+			return bounds.getX() + static_cast<float>(p + 1) * utils.thicc;
+		}
+
+		float getY(float value) const noexcept
+		{
+			const auto h = bounds.getHeight();
+			if (!bipolar)
+				return h - value * h;
+			const auto heightHalf = h * .5f;
+			return bounds.getY() + heightHalf - value * heightHalf;
+		}
+
+		/* frame, point, min, max */
+		void getPoint(const Frame& frame, int p, float& mn, float& mx) const noexcept
+		{
+			const auto numPoints = getNumPoints();
+			const auto barBins = getBarBins(frame);
 
-performance: only repaint part if the interface that was changed
+			// the coarsest level that still has a bin per point
+			auto level = 0;
+			while (level + 1 < Oscope::NumLevels && barBins / static_cast<float>(1 << (level + 1)) >= static_cast<float>(numPoints))
+				++level;
+			const auto mins = frame.mins.data() + Oscope::getLevelOffset(level);
+			const auto maxs = frame.maxs.data() + Oscope::getLevelOffset(level);
+			const auto numBins = Oscope::getNumBins(level);
+			const auto binsPerPoint = barBins / static_cast<float>(1 << level) / static_cast<float>(numPoints);
 
-*/
\ No newline at end of file
+			const auto b0 = std::min(numBins - 1, static_cast<int>(static_cast<float>(p) * binsPerPoint));
+			const auto b1 = std::min(numBins, std::max(b0 + 1, static_cast<int>(static_cast<float>(p + 1) * binsPerPoint)));
+			mn = mins[b0];
+			mx = maxs[b0];
+			for (auto b = b0 + 1; b < b1; ++b)
+			{
+				mn = std::min(mn, mins[b]);
+				mx = std::max(mx, maxs[b]);
+			}
+		}
+
+		/* frame, first point, last point */
+		void updatePoints(const Frame& frame, int p0, int p1)
+		{
+			const auto thicc = utils.thicc;
+			const auto numPoints = getNumPoints();
+
+			// the stroke reaches into the neighbouring points
+			const auto x0 = static_cast<int>(std::floor(getX(p0 - 1)));
+			const auto x1 = static_cast<int>(std::ceil(getX(p1) + thicc));
+			const auto dirty = juce::Rectangle<int>(x0, 0, x1 - x0, getHeight())
+				.getIntersection(getLocalBounds());
+			if (dirty.isEmpty())
+				return;
+			curveImage.clear((dirty.toFloat() * scale).getSmallestIntegerContainer()
+				.getIntersection(curveImage.getBounds()));
+
+			const auto first = std::max(0, p0 - 2);
+			const auto last = std::min(numPoints - 1, p1 + 2);
+			float mn, mx;
+			getPoint(frame, first, mn, mx);
+			auto lastMid = .5f * (mn + mx);
+			curve.clear();
+			curve.startNewSubPath(getX(first - 1), getY(lastMid));
+			for (auto p = first; p <= last; ++p)
+			{
+				getPoint(frame, p, mn, mx);
+
+				// the extremes are drawn in the direction of the signal to keep the line continuous
+				const auto x = getX(p);
+				const auto mid = .5f * (mn + mx);
+				const auto rising = mid >= lastMid;
+				curve.lineTo(x, getY(rising ? mn : mx));
+				if (mn != mx)
+					curve.lineTo(x, getY(rising ? mx : mn));
+				lastMid = mid;
+			}
+
+			{
+				Graphics g(curveImage);
+				g.addTransform(juce::AffineTransform::scale(scale));
+				g.reduceClipRegion(dirty);
+				Stroke stroke(thicc, Stroke::JointStyle::beveled, Stroke::EndCapStyle::rounded);
+				g.setColour(Colours::c(lineCID));
+				g.strokePath(curve, stroke);
+			}
+
+			repaint(dirty);
+		}
+	};
+}
@@ -24,83 +24,20 @@ namespace gui
 		return author + "_-_" + name + ".patch";
 	}
 
-	String getFileName(const Patch& patch)
-	{
-		return getFileName(patch.name.getText(), patch.author.getText());
-	}
-	
-	// Patch
+	// PatchRecord
 
-	Patch::Patch(Utils& u, const String& _name, const String& _author) :
-		Button(u, "Click on this patch in order to select it."),
-		name(u, _name),
-		author(u, _author),
-		file()
+	bool PatchRecord::isRemovable() const
 	{
+		return author != "factory";
 	}
 
-	Patch::Patch(Utils& u, const File& _file) :
+	// Patch
+
+	Patch::Patch(Utils& u) :
 		Button(u, "Click on this patch in order to select it."),
 		name(u, ""),
 		author(u, ""),
-		file(_file)
-	{
-		const auto fileName = file.getFileNameWithoutExtension();
-		// for instance: user_-_best patch ever.patch
-		for (auto i = 0; i < fileName.length(); ++i)
-		{
-			const auto chr = fileName[i];
-			if (chr == '_')
-				if (fileName.substring(i, i + 3) == "_-_")
-				{
-					author.setText(fileName.substring(0, i));
-					name.setText(fileName.substring(i + 3));
-				}
-		}
-		init();
-	}
-
-	Patch::Patch(Utils& u, const String& _name, const String& _author, const ValueTree& vt) :
-		Button(u, "Click on this patch in order to select it."),
-		name(u, _name),
-		author(u, _author),
-		file()
-	{
-		const auto directory = getDirectory(utils.getProps());
-		file = File(directory.getFullPathName() + "\\" + getFileName(_name, _author));
-
-		if (file.exists())
-			file.deleteFile();
-		file.appendText(vt.toXmlString());
-
-		init();
-	}
-
-	bool Patch::operator==(const Patch& other) const noexcept
-	{
-		return other.name.getText() == name.getText()
-			&& other.author.getText() == author.getText();
-	}
-
-	bool Patch::operator!=(const Patch& other) const noexcept
-	{
-		return !this->operator==(other);
-	}
-
-	bool Patch::isRemovable() const
-	{
-		return author.getText() != "factory";
-	}
-
-	void Patch::resized()
-	{
-		layout.resized();
-
-		layout.place(name, 1, 0, 1, 1, false);
-		layout.place(author, 2, 0, 1, 1, false);
-	}
-
-	void Patch::init()
+		recordIdx(-1)
 	{
 		layout.init
 		(
@@ -126,12 +63,35 @@ namespace gui
 		addAndMakeVisible(author);
 	}
 
+	void Patch::bind(const PatchRecord& record, int idx)
+	{
+		recordIdx = idx;
+		if (name.getText() != record.name)
+			name.setText(record.name);
+		if (author.getText() != record.author)
+			author.setText(record.author);
+	}
+
+	void Patch::resized()
+	{
+		layout.resized();
+
+		layout.place(name, 1, 0, 1, 1, false);
+		layout.place(author, 2, 0, 1, 1, false);
+	}
+
 	// Patches
 
 	Patches::Patches(Utils& u) :
 		CompScrollable(u),
-		patches(),
-		listBounds()
+		records(),
+		keys(),
+		order(),
+		rows(),
+		sortFunc(),
+		filter(),
+		listBounds(),
+		selected(-1)
 	{
 		layout.init
 		(
@@ -139,23 +99,21 @@ namespace gui
 			{ 1 }
 		);
 
-		if (numPatches() == 0)
-		{
-			save("Init", "Factory");
-		}
+		// only written once, so it doesn't touch the folder's mtime that the index relies on.
+		// the index picks it up from disk like every other patch
+		const auto initFile = getDirectory(u.getProps()).getChildFile(getFileName("Init", "Factory"));
+		if (!initFile.existsAsFile() && initFile.create().wasOk())
+			initFile.replaceWithText(u.savePatch().toXmlString());
 	}
 
-	int Patches::getIdx(const Patch& nPatch) const noexcept
+	String Patches::makeKey(const String& name, const String& author)
 	{
-		for (auto i = 0; i < numPatches(); ++i)
-			if (nPatch == *patches[i])
-				return i;
-		return -1;
+		return author + "\n" + name;
 	}
 
-	bool Patches::contains(const Patch& nPatch) const noexcept
+	bool Patches::contains(const String& name, const String& author) const
 	{
-		return getIdx(nPatch) != -1;
+		return keys.find(makeKey(name, author)) != keys.end();
 	}
 
 	bool Patches::save(const String& name, const String& author)
@@ -165,170 +123,80 @@ namespace gui
 
 		const auto auth = author.isEmpty() ? "user" : author;
 
-		Patch nPatch(utils, name, auth);
-
-		if (contains(nPatch))
+		if (contains(name, auth))
 			return false;
 
-		patches.push_back(std::make_unique<Patch>(utils, name, auth, utils.savePatch()));
-		auto& patch = *patches.back();
-
-		patch.onClick.push_back([&list = patches](Button& btn, const Mouse&)
-			{
-				for (auto& p : list)
-					p->toggleState = 0;
-
-				btn.toggleState = 1;
-			});
-
-		patch.onClick.push_back([&, &file = patch.file](Button& btn, const Mouse&)
-			{
-				auto& utils = btn.utils;
-				const auto stream = file.createInputStream();
-				if (stream != nullptr)
-				{
-					const auto vt = ValueTree::fromXml(stream->readEntireStreamAsString());
-					utils.loadPatch(vt);
-					notify(EvtType::PatchUpdated, nullptr);
-				}
-			});
-
-		patch.onMouseWheel.push_back([&](Button&, const Mouse& mouse, const MouseWheel& wheel)
-			{
-				mouseWheelMove(mouse, wheel);
-			});
+		const auto vt = utils.savePatch();
+		const auto file = getDirectory(utils.getProps()).getChildFile(getFileName(name, auth));
+		if (file.exists())
+			file.deleteFile();
+		file.appendText(vt.toXmlString());
 
-		addAndMakeVisible(patch);
-		select(&patch);
-
-		resized();
-		repaintWithChildren(this);
+		records.push_back({ name, auth, name.toLowerCase(), file });
+		keys.insert(makeKey(name, auth));
+		selected = static_cast<int>(records.size()) - 1;
+		updateOrder();
 
 		return true;
 	}
 
-	bool Patches::add(const File& file)
+	bool Patches::add(const PatchIndex::Entry& entry)
 	{
-		Patch nPatch(utils, file);
-
-		if (contains(nPatch))
+		if (!keys.insert(makeKey(entry.name, entry.author)).second)
 			return false;
 
-		patches.push_back(std::make_unique<Patch>(utils, file));
-		auto& patch = *patches.back();
-
-		patch.onClick.push_back([&list = patches](Button& btn, const Mouse&)
-			{
-				for (auto& p : list)
-					p->toggleState = 0;
-
-				btn.toggleState = 1;
-			});
-
-		patch.onClick.push_back([&, &file = patch.file](Button& btn, const Mouse&)
-			{
-				auto& utils = btn.getUtils();
-				const auto stream = file.createInputStream();
-				if (stream != nullptr)
-				{
-					const auto vt = ValueTree::fromXml(stream->readEntireStreamAsString());
-					utils.loadPatch(vt);
-					notify(EvtType::PatchUpdated, nullptr);
-				}
-			});
-
-		patch.onMouseWheel.push_back([&](Button&, const Mouse& mouse, const MouseWheel& wheel)
-			{
-				mouseWheelMove(mouse, wheel);
-			});
-
-		addAndMakeVisible(patch);
-		select(&patch);
-
+		records.push_back({ entry.name, entry.author, entry.name.toLowerCase(), entry.file });
 		return true;
 	}
 
 	bool Patches::removeSelected()
 	{
-		const auto directory = getDirectory(utils.getProps());
-
-		auto selected = getSelected();
-
-		if (selected != nullptr && selected->isRemovable())
-			for (auto i = 0; i < patches.size(); ++i)
-			{
-				const auto& patch = *patches[i];
-
-				if (patch == *selected)
-				{
-					select(nullptr);
-
-					const File file(directory.getFullPathName() + "\\" + getFileName(patch));
-					if (file.existsAsFile())
-						file.deleteFile();
-
-					patches.erase(patches.begin() + i);
+		const auto record = getSelected();
+		if (record == nullptr || !record->isRemovable())
+			return false;
 
-					resized();
-					repaintWithChildren(this);
+		if (record->file.existsAsFile())
+			record->file.deleteFile();
 
-					return true;
-				}
-			}
+		keys.erase(makeKey(record->name, record->author));
+		records.erase(records.begin() + selected);
+		selected = -1;
+		updateOrder();
 
-		return false;
+		return true;
 	}
 
-	bool Patches::select(Patch* nPatch) noexcept
+	bool Patches::select(int idx) noexcept
 	{
-		for (auto& p : patches)
-			p->toggleState = 0;
+		selected = idx >= 0 && idx < numPatches() ? idx : -1;
 
-		if (nPatch == nullptr)
-			return false;
-
-		for (auto& ptchs : patches)
-			if (*ptchs == *nPatch)
-			{
-				nPatch->toggleState = 1;
-				return true;
-			}
+		for (auto& row : rows)
+			row->toggleState = row->recordIdx == selected && selected != -1 ? 1 : 0;
+		repaintWithChildren(this);
 
-		return false;
+		return selected != -1;
 	}
 
 	int Patches::getSelectedIdx() const noexcept
 	{
-		for (auto i = 0; i < numPatches(); ++i)
-			if (patches[i]->toggleState == 1)
-				return i;
-		return -1;
+		return selected;
 	}
 
-	const Patch* Patches::getSelected() const noexcept
+	const Patches::Record* Patches::getSelected() const noexcept
 	{
-		auto idx = getSelectedIdx();
-		if (idx == -1)
+		if (selected == -1)
 			return nullptr;
-		return patches[idx].get();
+		return &records[selected];
 	}
 
-	Patch& Patches::back() noexcept { return *patches.back(); }
-
-	const Patch& Patches::back() const noexcept { return *patches.back(); }
-
-	Patch& Patches::operator[](int i) noexcept { return *patches[i]; }
-
-	const Patch& Patches::operator[](int i) const noexcept { return *patches[i]; }
+	const Patches::Record& Patches::operator[](int i) const noexcept { return records[i]; }
 
-	size_t Patches::numPatches() const noexcept { return patches.size(); }
+	size_t Patches::numPatches() const noexcept { return records.size(); }
 
-	void Patches::sort(const SortFunc& sortFunc)
+	void Patches::sort(const SortFunc& _sortFunc)
 	{
-		std::sort(patches.begin(), patches.end(), sortFunc);
-
-		resized();
-		repaintWithChildren(this);
+		sortFunc = _sortFunc;
+		updateOrder();
 	}
 
 	void Patches::resized()
@@ -341,45 +209,46 @@ namespace gui
 
 		const auto x = listBounds.getX();
 		const auto w = listBounds.getWidth();
-		const auto h = utils.thicc * PatchRelHeight;
-		actualHeight = h * static_cast<float>(numPatches());
-
-		auto y = listBounds.getY() - yScrollOffset;
-
-		for (auto p = 0; p < numPatches(); ++p)
+		const auto h = getRowHeight();
+		actualHeight = h * static_cast<float>(order.size());
+		yScrollOffset = juce::jlimit(0.f, std::max(0.f, actualHeight - listBounds.getHeight()), yScrollOffset);
+
+		// enough rows to cover the viewport while it's between two rows
+		const auto numOrdered = static_cast<int>(order.size());
+		const auto numRows = std::min(numOrdered, static_cast<int>(std::ceil(listBounds.getHeight() / h)) + 1);
+		while (static_cast<int>(rows.size()) < numRows)
+			makeRow();
+
+		const auto first = static_cast<int>(yScrollOffset / h);
+		for (auto r = 0; r < static_cast<int>(rows.size()); ++r)
 		{
-			auto& patch = *patches[p];
-
-			if (patch.isVisible())
+			auto& row = *rows[r];
+			const auto i = first + r;
+			if (r >= numRows || i >= numOrdered)
 			{
-				patch.setBounds(BoundsF(x, y, w, h).toNearestInt());
-				y += h;
+				row.setVisible(false);
+				row.recordIdx = -1;
+				continue;
 			}
+
+			const auto recordIdx = order[i];
+			row.bind(records[recordIdx], recordIdx);
+			row.toggleState = recordIdx == selected ? 1 : 0;
+			const auto y = listBounds.getY() + static_cast<float>(i) * h - yScrollOffset;
+			row.setBounds(BoundsF(x, y, w, h).toNearestInt());
+			row.setVisible(true);
 		}
 	}
 
 	void Patches::applyFilters(const String& text)
 	{
-		if (text.isEmpty())
-		{
-			for (auto& patch : patches)
-				patch->setVisible(true);
-		}
-		else
-		{
-			const auto txt = text.toLowerCase();
-
-			for (auto& patch : patches)
-				patch->setVisible(patch->name.getText().toLowerCase().contains(txt));
-		}
-
-		resized();
-		repaintWithChildren(this);
+		filter = text.toLowerCase();
+		updateOrder();
 	}
 
 	void Patches::paint(Graphics& g)
 	{
-		if (patches.empty())
+		if (records.empty())
 		{
 			g.setColour(Colours::c(ColourID::Abort));
 			g.setFont(getFontLobster().withHeight(24.f));
@@ -397,14 +266,15 @@ namespace gui
 
 	void Patches::paintList(Graphics& g)
 	{
-		auto x = listBounds.getX();
-		auto y = listBounds.getY() - yScrollOffset;
-		auto w = listBounds.getWidth();
-		auto btm = listBounds.getBottom();
-		auto r = utils.thicc * PatchRelHeight;
+		const auto x = listBounds.getX();
+		const auto w = listBounds.getWidth();
+		const auto btm = listBounds.getBottom();
+		const auto r = getRowHeight();
+		const auto first = static_cast<int>(yScrollOffset / r);
+		auto y = listBounds.getY() + static_cast<float>(first) * r - yScrollOffset;
 
 		g.setColour(Colours::c(ColourID::Txt).withAlpha(.1f));
-		for (auto i = 0; i < numPatches(); ++i)
+		for (auto i = first; i < static_cast<int>(order.size()); ++i)
 		{
 			if (y >= btm)
 				return;
@@ -415,6 +285,63 @@ namespace gui
 		}
 	}
 
+	void Patches::updateOrder()
+	{
+		order.clear();
+		order.reserve(records.size());
+		for (auto i = 0; i < static_cast<int>(records.size()); ++i)
+			if (filter.isEmpty() || records[i].nameLower.contains(filter))
+				order.push_back(i);
+
+		if (sortFunc)
+			std::stable_sort(order.begin(), order.end(), [&](int a, int b)
+			{
+				return sortFunc(records[a], records[b]);
+			});
+
+		resized();
+		repaintWithChildren(this);
+	}
+
+	void Patches::load(int idx)
+	{
+		if (idx < 0 || idx >= numPatches())
+			return;
+
+		const auto stream = records[idx].file.createInputStream();
+		if (stream != nullptr)
+		{
+			const auto vt = ValueTree::fromXml(stream->readEntireStreamAsString());
+			utils.loadPatch(vt);
+			notify(EvtType::PatchUpdated, nullptr);
+		}
+	}
+
+	float Patches::getRowHeight() const noexcept
+	{
+		return std::max(1.f, utils.thicc * PatchRelHeight);
+	}
+
+	void Patches::makeRow()
+	{
+		rows.push_back(std::make_unique<Patch>(utils));
+		auto& row = *rows.back();
+
+		row.onClick.push_back([&](Button& btn, const Mouse&)
+			{
+				const auto idx = static_cast<Patch&>(btn).recordIdx;
+				select(idx);
+				load(idx);
+			});
+
+		row.onMouseWheel.push_back([&](Button&, const Mouse& mouse, const MouseWheel& wheel)
+			{
+				mouseWheelMove(mouse, wheel);
+			});
+
+		addChildComponent(row);
+	}
+
 	// PatchesSortable
 
 	PatchesSortable::PatchesSortable(Utils& u) :
@@ -438,10 +365,10 @@ namespace gui
 			{
 				btn.toggleState = btn.toggleState == 0 ? 1 : 0;
 
-				SortFunc sortFunc = [&ts = btn.toggleState](const UniquePatch& a, const UniquePatch& b)
+				SortFunc sortFunc = [&ts = btn.toggleState](const Record& a, const Record& b)
 				{
-					const auto& pA = a->name.getText();
-					const auto& pB = b->name.getText();
+					const auto& pA = a.name;
+					const auto& pB = b.name;
 
 					if (ts == 1)
 						return pA.compareNatural(pB) > 0;
@@ -456,10 +383,10 @@ namespace gui
 			{
 				btn.toggleState = btn.toggleState == 0 ? 1 : 0;
 
-				SortFunc sortFunc = [&ts = btn.toggleState](const UniquePatch& a, const UniquePatch& b)
+				SortFunc sortFunc = [&ts = btn.toggleState](const Record& a, const Record& b)
 				{
-					const auto& pA = a->author.getText();
-					const auto& pB = b->author.getText();
+					const auto& pA = a.author;
+					const auto& pB = b.author;
 
 					if (ts == 1)
 						return pA.compareNatural(pB) > 0;
@@ -490,24 +417,14 @@ namespace gui
 		addAndMakeVisible(patches);
 	}
 
-	int PatchesSortable::getIdx(const Patch& nPatch) const noexcept
-	{
-		return patches.getIdx(nPatch);
-	}
-
-	bool PatchesSortable::contains(const Patch& nPatch) const noexcept
-	{
-		return patches.contains(nPatch);
-	}
-
 	bool PatchesSortable::save(const String& name, const String& author)
 	{
 		return patches.save(name, author);
 	}
 
-	bool PatchesSortable::add(const File& file)
+	bool PatchesSortable::add(const PatchIndex::Entry& entry)
 	{
-		return patches.add(file);
+		return patches.add(entry);
 	}
 
 	bool PatchesSortable::removeSelected()
@@ -515,9 +432,9 @@ namespace gui
 		return patches.removeSelected();
 	}
 
-	bool PatchesSortable::select(Patch* nPatch) noexcept
+	bool PatchesSortable::select(int idx) noexcept
 	{
-		return patches.select(nPatch);
+		return patches.select(idx);
 	}
 
 	int PatchesSortable::getSelectedIdx() const noexcept
@@ -525,18 +442,12 @@ namespace gui
 		return patches.getSelectedIdx();
 	}
 
-	const Patch* PatchesSortable::getSelected() const noexcept
+	const PatchesSortable::Record* PatchesSortable::getSelected() const noexcept
 	{
 		return patches.getSelected();
 	}
 
-	Patch& PatchesSortable::back() noexcept { return patches.back(); }
-
-	const Patch& PatchesSortable::back() const noexcept { return patches.back(); }
-
-	Patch& PatchesSortable::operator[](int i) noexcept { return patches[i]; }
-
-	const Patch& PatchesSortable::operator[](int i) const noexcept { return patches[i]; }
+	const PatchesSortable::Record& PatchesSortable::operator[](int i) const noexcept { return patches[i]; }
 
 	size_t PatchesSortable::numPatches() const noexcept { return patches.numPatches(); }
 
@@ -591,7 +502,12 @@ namespace gui
 		patches(u),
 
 		searchBar(u, "Define a name or search for a patch!", "Init.."),
-		authorEditor(u, "Define your author name if you want to save a patch!", "Author..")
+		authorEditor(u, "Define your author name if you want to save a patch!", "Author.."),
+
+		index(getDirectory(u.getProps()), [this](const PatchIndex::Entries& entries)
+			{
+				addPatches(entries);
+			})
 	{
 		setInterceptsMouseClicks(true, true);
 
@@ -600,10 +516,6 @@ namespace gui
 			const auto& user = *props.getUserSettings();
 			const auto lastAuthorName = user.getValue("patchBrowserLastAuthor", "user");
 			authorEditor.setText(lastAuthorName);
-			const auto pathStr = getPatchesPath(user);
-			const File directory(pathStr);
-			directory.createDirectory();
-			loadPatchesFromDisk(directory);
 		}
 
 		layout.init
@@ -681,7 +593,7 @@ namespace gui
 							);
 			});
 
-		patches.select(nullptr);
+		patches.select(-1);
 
 #if DebugNumPatches != 0
 		Random rand;
@@ -742,7 +654,7 @@ namespace gui
 	{
 		const auto patch = patches.getSelected();
 		if (patch != nullptr)
-			return patch->name.getText();
+			return patch->name;
 		return "init";
 	}
 
@@ -773,35 +685,29 @@ namespace gui
 		patches.applyFilters(str);
 	}
 
-	void PatchBrowser::loadPatchesFromDisk(const File& directory)
+	void PatchBrowser::addPatches(const PatchIndex::Entries& entries)
 	{
-		const auto fileTypes = File::TypesOfFileToFind::findFiles;
-		const String extension(".patch");
-		const auto wildCard = "*" + extension;
-		const RangedDirectoryIterator files
-		(
-			directory,
-			true,
-			wildCard,
-			fileTypes
-		);
+		auto added = false;
+		for (const auto& entry : entries)
+			added = patches.add(entry) || added;
 
-		for (const auto& it : files)
-			patches.add(it.getFile());
+		// lays out and filters the new patches too
+		if (added)
+			applyFilters();
 	}
 
 	// ButtonPatchBrowser
 
 	Notify ButtonPatchBrowser::makeNotify(ButtonPatchBrowser& _bpb)
 	{
-		return [&bpb = _bpb](EvtType evt, const void*)
+		return Notify({ EvtType::PatchUpdated }, [&bpb = _bpb](EvtType evt, const void*)
 		{
 			if (evt == EvtType::PatchUpdated)
 			{
 				bpb.getLabel().setText(bpb.browser.getSelectedPatchName());
 				bpb.repaint();
 			}
-		};
+		});
 	}
 
 	ButtonPatchBrowser::ButtonPatchBrowser(Utils& u, PatchBrowser& _browser) :
@@ -1,6 +1,8 @@
 #pragma once
 #include "TextEditor.h"
+#include "PatchIndex.h"
 #include "../arch/State.h"
+#include <unordered_set>
 
 #define DebugNumPatches 0
 
@@ -11,74 +13,63 @@ namespace gui
 
 	String getFileName(const String& name, const String& author);
 
-	struct Patch :
-		public Button
+	/* one patch of the browser's list */
+	struct PatchRecord
 	{
-		/*
-		utils, name, author
-		constructor for making temporary patches
-		*/
-		Patch(Utils&, const String&, const String&);
-
-		/*
-		utils, file
-		constructor for reading patch from file */
-		Patch(Utils&, const File&);
-
-		/*
-		utils, name, author, valueTree
-		constructor for saving patch from plugin state */
-		Patch(Utils&, const String&, const String&, const ValueTree&);
+		String name, author, nameLower;
+		File file;
 
-		bool operator==(const Patch&) const noexcept;
+		bool isRemovable() const;
+	};
 
-		bool operator!=(const Patch&) const noexcept;
+	/* a row of the patch list, bound to whichever record is scrolled into it */
+	struct Patch :
+		public Button
+	{
+		Patch(Utils&);
 
-		bool isRemovable() const;
+		/* record, recordIdx */
+		void bind(const PatchRecord&, int);
 
 		void resized() override;
 
 		Label name, author;
-		File file;
-
-	protected:
-		void init();
+		int recordIdx;
 	};
 
 	static constexpr float PatchRelHeight = 8.f;
 
+	/*
+	* the patch list. the records are a flat array, sorting and filtering only reorder indices.
+	* rows are only made for the visible part of the list and rebound to other records while scrolling.
+	*/
 	struct Patches :
 		public CompScrollable
 	{
-		using UniquePatch = std::unique_ptr<Patch>;
-		using SortFunc = std::function<bool(const UniquePatch&, const UniquePatch&)>;
+		using Record = PatchRecord;
+		using SortFunc = std::function<bool(const Record&, const Record&)>;
 
 		Patches(Utils&);
 
-		int getIdx(const Patch&) const noexcept;
-
-		bool contains(const Patch&) const noexcept;
+		/* name, author */
+		bool contains(const String&, const String&) const;
 
 		/* name, author */
 		bool save(const String&, const String&);
 
-		bool add(const File&);
+		/* adds a patch found by the index without selecting it. call applyFilters once done adding */
+		bool add(const PatchIndex::Entry&);
 
 		bool removeSelected();
 
-		bool select(Patch*) noexcept;
+		/* record idx, -1 deselects */
+		bool select(int) noexcept;
 
 		int getSelectedIdx() const noexcept;
 
-		const Patch* getSelected() const noexcept;
+		const Record* getSelected() const noexcept;
 
-		Patch& back() noexcept;
-
-		const Patch& back() const noexcept;
-
-		Patch& operator[](int) noexcept;
-
-		const Patch& operator[](int) const noexcept;
+		const Record& operator[](int) const noexcept;
 
 		size_t numPatches() const noexcept;
 
@@ -93,42 +84,52 @@ namespace gui
 		void paintList(Graphics&);
 
 	protected:
-		std::vector<UniquePatch> patches;
+		std::vector<Record> records;
+		// author and name of every record, for the duplicate check
+		std::unordered_set<String> keys;
+		// the records that pass the filter, in sort order
+		std::vector<int> order;
+		std::vector<std::unique_ptr<Patch>> rows;
+		SortFunc sortFunc;
+		String filter;
 		BoundsF listBounds;
+		int selected;
+
+		void updateOrder();
+
+		/* name, author */
+		static String makeKey(const String&, const String&);
+
+		/* record idx */
+		void load(int);
+
+		float getRowHeight() const noexcept;
+
+		void makeRow();
 	};
 
 	struct PatchesSortable :
 		public Comp
 	{
-		using UniquePatch = Patches::UniquePatch;
 		using SortFunc = Patches::SortFunc;
+		using Record = Patches::Record;
 
 		PatchesSortable(Utils&);
 
-		int getIdx(const Patch&) const noexcept;
-
-		bool contains(const Patch&) const noexcept;
-
 		/* name, author */
 		bool save(const String&, const String&);
 
-		bool add(const File&);
+		bool add(const PatchIndex::Entry&);
 
 		bool removeSelected();
 
-		bool select(Patch*) noexcept;
+		bool select(int) noexcept;
 
 		int getSelectedIdx() const noexcept;
 
-		const Patch* getSelected() const noexcept;
-
-		Patch& back() noexcept;
+		const Record* getSelected() const noexcept;
 
-		const Patch& back() const noexcept;
-
-		Patch& operator[](int i) noexcept;
-
-		const Patch& operator[](int i) const noexcept;
+		const Record& operator[](int i) const noexcept;
 
 		size_t numPatches() const noexcept;
 
@@ -170,13 +171,17 @@ namespace gui
 
 		TextEditor searchBar, authorEditor;
 
+		// fills the browser in the background, keep it last
+		PatchIndex index;
+
 		void savePatch();
 
 		void removePatch();
 
 		void applyFilters();
 
-		void loadPatchesFromDisk(const File&);
+		/* entries, called by the index as it finds patches */
+		void addPatches(const PatchIndex::Entries&);
 	};
 
 	struct ButtonPatchBrowser :
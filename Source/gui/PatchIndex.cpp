@@ -0,0 +1,203 @@
+#include "PatchIndex.h"
+
+namespace gui
+{
+	void parsePatchFileName(const String& fileName, String& name, String& author)
+	{
+		for (auto i = 0; i < fileName.length(); ++i)
+		{
+			const auto chr = fileName[i];
+			if (chr == '_')
+				if (fileName.substring(i, i + 3) == "_-_")
+				{
+					author = fileName.substring(0, i);
+					name = fileName.substring(i + 3);
+				}
+		}
+	}
+
+	PatchIndex::PatchIndex(const File& _directory, OnEntries&& _onEntries) :
+		juce::Thread("PatchIndex"),
+		Timer(),
+		directory(_directory),
+		indexFile(_directory.getSiblingFile(_directory.getFileName() + ".index")),
+		onEntries(std::move(_onEntries)),
+		pendingLock(),
+		pending(),
+		batch(),
+		done(false)
+	{
+		startTimerHz(PublishHz);
+		startThread();
+	}
+
+	PatchIndex::~PatchIndex()
+	{
+		stopTimer();
+		stopThread(4000);
+	}
+
+	void PatchIndex::run()
+	{
+		directory.createDirectory();
+
+		// the cached folders, by relative path
+		std::map<String, ValueTree> cache;
+		for (const auto& dir : readIndex())
+			cache[dir.getProperty("path").toString()] = dir;
+
+		std::vector<File> dirs{ directory };
+		for (const auto& it : RangedDirectoryIterator(directory, true, "*", File::findDirectories))
+			dirs.push_back(it.getFile());
+
+		ValueTree index("index");
+		index.setProperty("version", Version, nullptr);
+		auto changed = cache.size() != dirs.size();
+
+		for (const auto& dir : dirs)
+		{
+			if (threadShouldExit())
+				return;
+
+			const auto path = dir.getRelativePathFrom(directory);
+			const auto mtime = dir.getLastModificationTime().toMilliseconds();
+			const auto cached = cache.find(path);
+			const auto isCached = cached != cache.end();
+
+			if (isCached && static_cast<juce::int64>(cached->second.getProperty("mtime")) == mtime)
+			{
+				// nothing was added, removed or replaced in here
+				for (const auto& patch : cached->second)
+					publish(fromTree(dir, patch));
+				index.appendChild(cached->second.createCopy(), nullptr);
+				continue;
+			}
+			changed = true;
+
+			std::map<String, ValueTree> cachedPatches;
+			if (isCached)
+				for (const auto& patch : cached->second)
+					cachedPatches[patch.getProperty("file").toString()] = patch;
+
+			ValueTree dirTree("dir");
+			dirTree.setProperty("path", path, nullptr);
+			dirTree.setProperty("mtime", mtime, nullptr);
+			for (const auto& file : dir.findChildFiles(File::findFiles, false, "*.patch"))
+			{
+				if (threadShouldExit())
+					return;
+
+				// only new or modified patches are read
+				const auto cachedPatch = cachedPatches.find(file.getFileName());
+				const auto reuse = cachedPatch != cachedPatches.end()
+					&& static_cast<juce::int64>(cachedPatch->second.getProperty("mtime")) == file.getLastModificationTime().toMilliseconds();
+				auto patch = reuse ? cachedPatch->second.createCopy() : toTree(makeEntry(file));
+				publish(fromTree(dir, patch));
+				dirTree.appendChild(patch, nullptr);
+			}
+			index.appendChild(dirTree, nullptr);
+		}
+
+		flush();
+		if (changed)
+			writeIndex(index);
+		done.store(true);
+	}
+
+	void PatchIndex::timerCallback()
+	{
+		// read before the swap, so a last flush right before done is still delivered
+		const auto finished = done.load();
+		Entries entries;
+		{
+			const juce::ScopedLock sl(pendingLock);
+			entries.swap(pending);
+		}
+		if (!entries.empty())
+			onEntries(entries);
+		else if (finished)
+			stopTimer();
+	}
+
+	void PatchIndex::publish(Entry&& entry)
+	{
+		batch.push_back(std::move(entry));
+		if (static_cast<int>(batch.size()) >= BatchSize)
+			flush();
+	}
+
+	void PatchIndex::flush()
+	{
+		if (batch.empty())
+			return;
+		const juce::ScopedLock sl(pendingLock);
+		for (auto& entry : batch)
+			pending.push_back(std::move(entry));
+		batch.clear();
+	}
+
+	PatchIndex::Entry PatchIndex::makeEntry(const File& file) const
+	{
+		Entry entry;
+		entry.file = file;
+		parsePatchFileName(file.getFileNameWithoutExtension(), entry.name, entry.author);
+		entry.mtime = file.getLastModificationTime().toMilliseconds();
+
+		const auto text = file.loadFileAsString();
+		entry.hash = text.hashCode64();
+		// only the attributes of the outer element are parsed
+		juce::XmlDocument doc(text);
+		const auto xml = doc.getDocumentElement(true);
+		if (xml != nullptr)
+			entry.tags = xml->getStringAttribute("tags");
+		return entry;
+	}
+
+	PatchIndex::Entry PatchIndex::fromTree(const File& dir, const ValueTree& patch) const
+	{
+		Entry entry;
+		entry.file = dir.getChildFile(patch.getProperty("file").toString());
+		entry.name = patch.getProperty("name").toString();
+		entry.author = patch.getProperty("author").toString();
+		entry.tags = patch.getProperty("tags").toString();
+		entry.mtime = static_cast<juce::int64>(patch.getProperty("mtime"));
+		entry.hash = static_cast<juce::int64>(patch.getProperty("hash"));
+		return entry;
+	}
+
+	ValueTree PatchIndex::toTree(const Entry& entry) const
+	{
+		ValueTree patch("patch");
+		patch.setProperty("file", entry.file.getFileName(), nullptr);
+		patch.setProperty("name", entry.name, nullptr);
+		patch.setProperty("author", entry.author, nullptr);
+		patch.setProperty("tags", entry.tags, nullptr);
+		patch.setProperty("mtime", entry.mtime, nullptr);
+		patch.setProperty("hash", entry.hash, nullptr);
+		return patch;
+	}
+
+	ValueTree PatchIndex::readIndex() const
+	{
+		juce::FileInputStream stream(indexFile);
+		if (!stream.openedOk())
+			return ValueTree("index");
+		auto index = ValueTree::readFromStream(stream);
+		if (!index.isValid() || static_cast<int>(index.getProperty("version", 0)) != Version)
+			return ValueTree("index");
+		return index;
+	}
+
+	void PatchIndex::writeIndex(const ValueTree& index) const
+	{
+		// other instances might read it at the same time
+		juce::TemporaryFile temp(indexFile);
+		{
+			juce::FileOutputStream stream(temp.getFile());
+			if (!stream.openedOk())
+				return;
+			index.writeToStream(stream);
+		}
+		temp.overwriteTargetFileWithTemporary();
+	}
+}
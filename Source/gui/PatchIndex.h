@@ -0,0 +1,67 @@
+#pragma once
+#include "Using.h"
+
+namespace gui
+{
+	/* fileName (without extension), name, author. for instance: user_-_best patch ever */
+	void parsePatchFileName(const String&, String&, String&);
+
+	/*
+	* indexes the patch directory on a background thread.
+	* the index (name, author, tags, mtime and hash of every patch) is cached in a file next to
+	* the patch directory. folders whose modification time didn't change are taken from the cache
+	* without being listed, and only patches with a new modification time are read again.
+	* results are handed to the message thread in batches while the directory is being walked.
+	*/
+	struct PatchIndex :
+		public juce::Thread,
+		public Timer
+	{
+		struct Entry
+		{
+			File file;
+			String name, author, tags;
+			juce::int64 mtime, hash;
+		};
+
+		using Entries = std::vector<Entry>;
+		using OnEntries = std::function<void(const Entries&)>;
+
+		static constexpr int Version = 1;
+		static constexpr int BatchSize = 64;
+		static constexpr int PublishHz = 15;
+
+		/* directory, onEntries (called on the message thread) */
+		PatchIndex(const File&, OnEntries&&);
+
+		~PatchIndex() override;
+
+		void run() override;
+
+		void timerCallback() override;
+
+	protected:
+		const File directory, indexFile;
+		OnEntries onEntries;
+		juce::CriticalSection pendingLock;
+		Entries pending, batch;
+		std::atomic<bool> done;
+
+		/* entry, queues it for the message thread */
+		void publish(Entry&&);
+
+		void flush();
+
+		/* file, reads the patch */
+		Entry makeEntry(const File&) const;
+
+		/* dir, patch */
+		Entry fromTree(const File&, const ValueTree&) const;
+
+		ValueTree toTree(const Entry&) const;
+
+		ValueTree readIndex() const;
+
+		void writeIndex(const ValueTree&) const;
+	};
+}
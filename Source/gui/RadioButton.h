@@ -109,7 +109,7 @@ namespace gui
 				const auto valDenorm = param.getValueDenorm() - param.range.start;
 				const auto index = static_cast<int>(valDenorm);
 				setSelected(index);
-				front.startTimerHz(12);
+				utils.getScheduler().add(front, [&front]() { front.timerCallback(); }, { pID });
 			}
 		}
 		
@@ -0,0 +1,107 @@
+#include "Scheduler.h"
+
+namespace gui
+{
+	Scheduler::Scheduler(Component& pluginTop, Params& _params) :
+		params(_params),
+		subs(),
+		sequences(params.numParams(), 0),
+		vblank(&pluginTop, [this]() { onVBlank(); }),
+		removed(false)
+	{
+	}
+
+	void Scheduler::add(Component& comp, Callback&& callback, const std::vector<PID>& pIDs, bool whileHidden)
+	{
+		auto sub = std::make_unique<Subscription>();
+		sub->comp = &comp;
+		sub->callback = std::move(callback);
+		for (const auto pID : pIDs)
+			sub->pIDs.push_back(static_cast<int>(pID));
+		sub->intervalMs = pIDs.empty() ? 0. : 1000. / static_cast<double>(PPDFPSKnobs);
+		sub->lastMs = 0.;
+		sub->whileHidden = whileHidden;
+		// the first frame always updates
+		sub->stamp = getStamp(*sub) - 1;
+		subs.push_back(std::move(sub));
+	}
+
+	void Scheduler::add(Component& comp, Callback&& callback, float hz)
+	{
+		auto sub = std::make_unique<Subscription>();
+		sub->comp = &comp;
+		sub->callback = std::move(callback);
+		sub->stamp = 0;
+		sub->intervalMs = 1000. / static_cast<double>(hz);
+		sub->lastMs = 0.;
+		sub->whileHidden = false;
+		subs.push_back(std::move(sub));
+	}
+
+	void Scheduler::remove(const Component& comp)
+	{
+		for (auto& sub : subs)
+			if (sub->comp == &comp)
+			{
+				sub->comp = nullptr;
+				removed = true;
+			}
+	}
+
+	unsigned int Scheduler::getStamp(const Subscription& sub) const noexcept
+	{
+		// every change increments one of the sequences, so their sum changes too
+		auto stamp = 0u;
+		for (const auto pID : sub.pIDs)
+			stamp += sequences[pID];
+		return stamp;
+	}
+
+	void Scheduler::onVBlank()
+	{
+		const auto& ps = params.data();
+		for (auto p = 0; p < ps.size(); ++p)
+			sequences[p] = ps[p]->getChangeSequence();
+
+		const auto now = Time::getMillisecondCounterHiRes();
+
+		// subscriptions can be added from a callback, so no references are kept across calls
+		for (auto i = 0; i < subs.size(); ++i)
+		{
+			auto sub = subs[i].get();
+			if (sub->comp == nullptr)
+				continue;
+			if (!sub->whileHidden && !sub->comp->isShowing())
+				continue;
+
+			if (sub->pIDs.empty())
+			{
+				if (now - sub->lastMs < sub->intervalMs)
+					continue;
+				sub->lastMs = now;
+			}
+			else
+			{
+				const auto stamp = getStamp(*sub);
+				if (stamp == sub->stamp)
+					continue;
+				// keeps the old stamp, so the change is picked up once the interval passed
+				if (now - sub->lastMs < sub->intervalMs)
+					continue;
+				sub->stamp = stamp;
+				sub->lastMs = now;
+			}
+
+			sub->callback();
+		}
+
+		if (removed)
+		{
+			removed = false;
+			subs.erase(std::remove_if(subs.begin(), subs.end(), [](const std::unique_ptr<Subscription>& sub)
+			{
+				return sub->comp == nullptr;
+			}), subs.end());
+		}
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "Using.h"
+
+namespace gui
+{
+	/*
+	* drives the editor's periodic updates from the display's vblank.
+	* the change sequences of all parameters are read once per frame.
+	* a subscriber with parameters is only called when one of them changed,
+	* at most at PPDFPSKnobs, so modulated parameters don't repaint every frame.
+	* a subscriber without parameters is called at its rate.
+	* hidden components are skipped and catch up once they are shown again.
+	*/
+	struct Scheduler
+	{
+		using Callback = std::function<void()>;
+
+		/* pluginTop, params */
+		Scheduler(Component&, Params&);
+
+		/* comp, callback, pIDs, whileHidden (for comps that show or hide themselves) */
+		void add(Component&, Callback&&, const std::vector<PID>&, bool = false);
+
+		/* comp, callback, hz */
+		void add(Component&, Callback&&, float);
+
+		/* comp, removes all of its subscriptions */
+		void remove(const Component&);
+
+	protected:
+		struct Subscription
+		{
+			Component* comp;
+			Callback callback;
+			std::vector<int> pIDs;
+			unsigned int stamp;
+			double intervalMs, lastMs;
+			bool whileHidden;
+		};
+
+		Params& params;
+		std::vector<std::unique_ptr<Subscription>> subs;
+		std::vector<unsigned int> sequences;
+		juce::VBlankAttachment vblank;
+		bool removed;
+
+		/* subscription */
+		unsigned int getStamp(const Subscription&) const noexcept;
+
+		void onVBlank();
+	};
+}
@@ -1,27 +1,42 @@
 #include "Shader.h"
 
-gui::Shader::Shader(Utils& u, Component& _comp) :
-    Timer(),
-    comp(_comp),
-    utils(u),
-    notify(u.getEventSystem()),
+gui::Shader::Shader(Utils& u) :
+    Comp(u, "", CursorType::Default),
+    img(),
+    scale(1.f),
     bypassed(false)
 {
-    startTimerHz(12);
+    setInterceptsMouseClicks(false, false);
+    u.getScheduler().add(*this, [this]() { updateBypassed(); }, { PID::Power }, true);
 }
 
-void gui::Shader::applyEffect(Image& img, Graphics& g, float, float)
+void gui::Shader::paint(Graphics& g)
 {
-    g.drawImageAt(img, 0, 0, false);
+    // moved to a display with another scale
+    if (scale != Component::getApproximateScaleFactorForComponent(this))
+        updateImage();
+    g.drawImageTransformed(img, juce::AffineTransform::scale(1.f / scale), false);
+}
 
-    if (bypassed)
-        paintBypassed(img, g);
+void gui::Shader::resized()
+{
+    updateImage();
 }
 
-void gui::Shader::paintBypassed(Image& img, Graphics& g)
+void gui::Shader::updateImage()
 {
-    const auto h = static_cast<float>(img.getHeight()) * .5f;
-    const auto r = static_cast<float>(img.getWidth());
+    if (getWidth() < 1 || getHeight() < 1)
+        return;
+
+    scale = Component::getApproximateScaleFactorForComponent(this);
+    const auto width = static_cast<int>(std::ceil(static_cast<float>(getWidth()) * scale));
+    const auto height = static_cast<int>(std::ceil(static_cast<float>(getHeight()) * scale));
+    img = Image(Image::ARGB, width, height, true);
+    Graphics g(img);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
+    const auto h = static_cast<float>(getHeight()) * .5f;
+    const auto r = static_cast<float>(getWidth());
 
     PointF left(0.f, h);
     PointF right(r, h);
@@ -36,22 +51,15 @@ void gui::Shader::paintBypassed(Image& img, Graphics& g)
     g.setGradientFill(grad);
     g.fillAll();
     g.setColour(Colours::c(ColourID::Abort));
-    g.drawFittedText("bypassed", img.getBounds(), Just::centredRight, 1);
+    g.drawFittedText("bypassed", getLocalBounds(), Just::centredRight, 1);
 }
 
-void gui::Shader::timerCallback()
+void gui::Shader::updateBypassed()
 {
-    bool shallRepaint = false;
-
     auto b = utils.getParam(PID::Power)->getValue() < .5f;
     if (bypassed != b)
     {
         bypassed = b;
-        shallRepaint = true;
+        setVisible(bypassed);
     }
-
-    if (shallRepaint)
-    {
-        repaintWithChildren(&comp);
-    }
-}
\ No newline at end of file
+}
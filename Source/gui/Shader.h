@@ -1,24 +1,27 @@
 #pragma once
-#include "Utils.h"
-#include "Layout.h"
+#include "Comp.h"
 
 namespace gui
 {
+    // the bypass overlay. it sits on top of the editor and is only visible while bypassed.
     struct Shader :
-        juce::ImageEffectFilter,
-        Timer
+        public Comp
     {
-        Shader(Utils&, Component&);
+        Shader(Utils&);
 
-        void applyEffect(Image&, Graphics&, float, float) override;
+        void paint(Graphics&) override;
 
-        Component& comp;
-        Utils& utils;
-        Evt notify;
-        bool bypassed;
+        void resized() override;
+
+        // called by the scheduler when PID::Power changed
+        void updateBypassed();
 
-        void paintBypassed(Image&, Graphics&);
+    protected:
+        // at the display's resolution
+        Image img;
+        float scale;
+        bool bypassed;
 
-        void timerCallback() override;
+        void updateImage();
     };
-}
\ No newline at end of file
+}
@@ -95,9 +95,9 @@ namespace gui
             setInternal(ColourID::Hover, col.withMultipliedSaturation(2.f).brighter(2.f).withMultipliedAlpha(.3f));
             setInternal(ColourID::Inactive, col.withMultipliedSaturation(.1f));
 
+            // saved by the settings thread
             if (props->needsToBeSaved())
             {
-                props->save();
                 props->sendChangeMessage();
                 return true;
             }
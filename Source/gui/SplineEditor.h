@@ -170,6 +170,8 @@ namespace gui
 			bounds(),
 			points(),
 			curve(),
+			curveX(),
+			curveY(),
 			drag(*this),
 			grid(*this, false),
 			wannaUpdate(false),
@@ -254,24 +256,21 @@ namespace gui
 			for (const auto& pt : points)
 				ptAbs.emplace_back(toAbs(pt.relSnap));
 
-			const auto func = interpolate::polynomial::getFunc(ptAbs);
+			const interpolate::polynomial::Lagrange<float> poly(ptAbs);
 			const auto thicc2 = utils.thicc * 2.f;
 
-			auto x = limitAbsX(bounds.getX());
-			auto y = limitAbsY(func(x));
-			curve.startNewSubPath(x, y);
+			curveX.clear();
+			curveX.push_back(limitAbsX(bounds.getX()));
+			for (auto x = curveX[0] + thicc2; x < bounds.getRight(); x += thicc2)
+				curveX.push_back(x);
+			curveX.push_back(bounds.getRight());
 
-			while (x < bounds.getRight())
-			{
-				y = func(x);
-				curve.lineTo(limitAbsX(x), limitAbsY(y));
+			curveY.resize(curveX.size());
+			poly(curveY.data(), curveX.data(), static_cast<int>(curveX.size()));
 
-				x += thicc2;
-			}
-			
-			x = bounds.getRight();
-			y = func(x);
-			curve.lineTo(limitAbsX(x), limitAbsY(y));
+			curve.startNewSubPath(curveX[0], limitAbsY(curveY[0]));
+			for (auto i = 1; i < curveX.size(); ++i)
+				curve.lineTo(limitAbsX(curveX[i]), limitAbsY(curveY[i]));
 		}
 
 		void timerCallback() override
@@ -314,6 +313,7 @@ namespace gui
 		BoundsF bounds;
 		Points points;
 		Path curve;
+		std::vector<float> curveX, curveY;
 		DraggerFall drag;
 		Grid grid;
 		std::atomic<bool> wannaUpdate;
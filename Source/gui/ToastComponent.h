@@ -8,7 +8,7 @@ namespace gui
 	{
 		Notify makeNotify(ToastComp& t)
 		{
-			return [&toast = t](EvtType type, const void* stuff)
+			return Notify({ EvtType::Toast, EvtType::ClickedEmpty }, [&toast = t](EvtType type, const void* stuff)
 			{
 				if (type == EvtType::Toast)
 				{
@@ -24,7 +24,7 @@ namespace gui
 				{
 					toast.setVisible(false);
 				}
-			};
+			});
 		}
 	public:
 		ToastComp(Utils& u) :
@@ -44,14 +44,14 @@ namespace gui
 
 	Notify Tooltip::makeNotify(Tooltip* ttc)
 	{
-		return [ttc](const EvtType type, const void* stuff)
+		return Notify({ EvtType::TooltipUpdated }, [ttc](const EvtType type, const void* stuff)
 		{
 			if (type == EvtType::TooltipUpdated)
 			{
 				const auto str = static_cast<const String*>(stuff);
 				ttc->updateTooltip(str);
 			}
-		};
+		});
 	}
 
 }
\ No newline at end of file
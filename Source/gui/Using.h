@@ -11,6 +11,7 @@
 #include "../Processor.h"
 #include "../param/Param.h"
 #include "../arch/State.h"
+#include "../arch/Settings.h"
 #include "../audio/MIDIManager.h"
 
 #include <array>
@@ -22,8 +23,9 @@ namespace gui
     using Gradient = juce::ColourGradient;
     using String = juce::String;
     using Font = juce::Font;
+    using GlyphArrangement = juce::GlyphArrangement;
     using Props = juce::PropertiesFile;
-    using AppProps = juce::ApplicationProperties;
+    using AppProps = sta::Settings;
     using Cursor = juce::MouseCursor;
     using Image = juce::Image;
     using Graphics = juce::Graphics;
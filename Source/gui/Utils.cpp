@@ -9,9 +9,12 @@ namespace gui
 		params(audioProcessor.params),
 		eventSystem(),
 		evt(eventSystem),
+		scheduler(_pluginTop, params),
 		thicc(1.f)
 	{
-		Colours::c.init(audioProcessor.props.getUserSettings());
+		Colours::c.init(audioProcessor.props->getUserSettings());
+		// drags and tooltips are delivered once per frame
+		scheduler.add(pluginTop, [this]() { eventSystem.flush(); }, {}, true);
 	}
 
 	Param* Utils::getParam(PID pID) noexcept
@@ -108,6 +111,11 @@ namespace gui
 		return eventSystem;
 	}
 
+	Scheduler& Utils::getScheduler() noexcept
+	{
+		return scheduler;
+	}
+
 	const std::atomic<float>& Utils::getMeter(int i) const noexcept
 	{
 		return audioProcessor.meters(i);
@@ -16,7 +16,7 @@ namespace gui
 
 		Notify makeNotify(WaveTableDisplay& _wtd)
 		{
-			return [&wtd = _wtd](EvtType t, const void*)
+			return Notify({ EvtType::PatchUpdated, EvtType::FormulaUpdated }, [&wtd = _wtd](EvtType t, const void*)
 			{
 				if (t == EvtType::PatchUpdated)
 				{
@@ -26,7 +26,7 @@ namespace gui
 				{
 					wtd.repaint();
 				}
-			};
+			});
 		}
 
 		WaveTableDisplay(Utils& u, WT& _wt) :
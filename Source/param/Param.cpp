@@ -83,6 +83,23 @@ namespace param
 		case PID::Orientation: return "Orientation";
 		case PID::OutputType: return "Output Type";
 
+		case PID::ModPerlinRate: return "Mod Perlin Rate";
+		case PID::ModPerlinOctaves: return "Mod Perlin Octaves";
+		case PID::ModPerlinPhase: return "Mod Perlin Phase";
+		case PID::ModPerlinWidth: return "Mod Perlin Width";
+		case PID::ModEnvRate: return "Mod Env Rate";
+		case PID::ModEnvOctaves: return "Mod Env Octaves";
+		case PID::ModEnvPhase: return "Mod Env Phase";
+		case PID::ModEnvWidth: return "Mod Env Width";
+		case PID::ModCCRate: return "Mod CC Rate";
+		case PID::ModCCOctaves: return "Mod CC Octaves";
+		case PID::ModCCPhase: return "Mod CC Phase";
+		case PID::ModCCWidth: return "Mod CC Width";
+		case PID::RetrigMode: return "Retrig Mode";
+		case PID::RetrigChannel: return "Retrig Channel";
+		case PID::RetrigKeyLow: return "Retrig Key Low";
+		case PID::RetrigKeyHigh: return "Retrig Key High";
+
 		default: return "Invalid Parameter Name";
 		}
 	}
@@ -170,6 +187,22 @@ namespace param
 		case PID::RandType: return "Every noise segment corresponds to a distinct combination of rate, bpm and transport info.";
 		case PID::Orientation: return "Defines the range of the modulation. Omni [0,1], Bi [-1,1]";
 		case PID::OutputType: return "Output the modulation signal as MIDI CC(1) data on channel 1";
+		case PID::ModPerlinRate: return "How much the secondary perlin noise modulates the rate.";
+		case PID::ModPerlinOctaves: return "How much the secondary perlin noise modulates the octaves.";
+		case PID::ModPerlinPhase: return "How much the secondary perlin noise modulates the phase.";
+		case PID::ModPerlinWidth: return "How much the secondary perlin noise modulates the width.";
+		case PID::ModEnvRate: return "How much the input envelope modulates the rate.";
+		case PID::ModEnvOctaves: return "How much the input envelope modulates the octaves.";
+		case PID::ModEnvPhase: return "How much the input envelope modulates the phase.";
+		case PID::ModEnvWidth: return "How much the input envelope modulates the width.";
+		case PID::ModCCRate: return "How much the selected MIDI CC modulates the rate.";
+		case PID::ModCCOctaves: return "How much the selected MIDI CC modulates the octaves.";
+		case PID::ModCCPhase: return "How much the selected MIDI CC modulates the phase.";
+		case PID::ModCCWidth: return "How much the selected MIDI CC modulates the width.";
+		case PID::RetrigMode: return "What a MIDI note does to the perlin noise: nothing, restart its phase, reseed it per note or restart it with a crossfade.";
+		case PID::RetrigChannel: return "The MIDI channel whose notes retrigger the perlin noise. Omni listens to all of them.";
+		case PID::RetrigKeyLow: return "The lowest note that retriggers the perlin noise.";
+		case PID::RetrigKeyHigh: return "The highest note that retriggers the perlin noise.";
 
 		default: return "Invalid Tooltip.";
 		}
@@ -220,11 +253,16 @@ namespace param
 		range(_range),
 
 		state(_state),
+		valueKey(getIDString(pID), "value"),
+		maxModDepthKey(getIDString(pID), "maxmoddepth"),
+		modBiasKey(getIDString(pID), "modbias"),
+		kernel(range),
 		valDenormDefault(_valDenormDefault),
 
 		valNorm(range.convertTo0to1(_valDenormDefault)),
 		maxModDepth(0.f),
 		valMod(valNorm.load()),
+		valModDenorm(range.convertFrom0to1(valMod.load())),
 		modBias(.5f),
 
 		valToStr(_valToStr),
@@ -233,37 +271,35 @@ namespace param
 
 		locked(false),
 		inGesture(false),
+		dirty(true),
+		changeSequence(0),
 
 		modDepthLocked(false)
 	{
 	}
 
-	void Param::savePatch(juce::ApplicationProperties& appProps) const
+	void Param::savePatch(sta::Settings& appProps) const
 	{
-		const auto idStr = getIDString(id);
-
 		const auto v = range.convertFrom0to1(getValue());
-		state.set(idStr, "value", v, true);
+		state.set(valueKey, v, true);
 		const auto mdd = getMaxModDepth();
-		state.set(idStr, "maxmoddepth", mdd, true);
+		state.set(maxModDepthKey, mdd, true);
 		const auto mb = getModBias();
-		state.set(idStr, "modbias", mb, true);
+		state.set(modBiasKey, mb, true);
 
 		auto user = appProps.getUserSettings();
 		if (user->isValidFile())
 		{
-			user->setValue(idStr + "valDefault", valDenormDefault);
+			user->setValue(getIDString(id) + "valDefault", valDenormDefault);
 		}
 	}
 
-	void Param::loadPatch(juce::ApplicationProperties& appProps)
+	void Param::loadPatch(sta::Settings& appProps)
 	{
-		const auto idStr = getIDString(id);
-
 		const auto lckd = isLocked();
 		if (!lckd)
 		{
-			auto var = state.get(idStr, "value");
+			auto var = state.get(valueKey);
 			if (var)
 			{
 				const auto val = static_cast<float>(*var);
@@ -271,13 +307,13 @@ namespace param
 				const auto valD = range.convertTo0to1(legalVal);
 				setValueNotifyingHost(valD);
 			}
-			var = state.get(idStr, "maxmoddepth");
+			var = state.get(maxModDepthKey);
 			if (var)
 			{
 				const auto val = static_cast<float>(*var);
 				setMaxModDepth(val);
 			}
-			var = state.get(idStr, "modbias");
+			var = state.get(modBiasKey);
 			if (var)
 			{
 				const auto val = static_cast<float>(*var);
@@ -287,7 +323,7 @@ namespace param
 			auto user = appProps.getUserSettings();
 			if (user->isValidFile())
 			{
-				const auto vdd = user->getDoubleValue(idStr + "valDefault", static_cast<double>(valDenormDefault));
+				const auto vdd = user->getDoubleValue(getIDString(id) + "valDefault", static_cast<double>(valDenormDefault));
 				setDefaultValue(range.convertTo0to1(range.snapToLegalValue(static_cast<float>(vdd))));
 			}
 		}
@@ -311,7 +347,12 @@ namespace param
 			return;
 
 		if (!modDepthLocked)
-			return valNorm.store(normalized);
+		{
+			valNorm.store(normalized);
+			dirty.store(true);
+			changed();
+			return;
+		}
 
 		const auto p0 = valNorm.load();
 		const auto p1 = normalized;
@@ -321,6 +362,8 @@ namespace param
 
 		valNorm.store(p1);
 		setMaxModDepth(d1);
+		dirty.store(true);
+		changed();
 	}
 
 	// called by editor
@@ -361,6 +404,8 @@ namespace param
 			return;
 
 		maxModDepth.store(juce::jlimit(-1.f, 1.f, v));
+		dirty.store(true);
+		changed();
 	}
 
 	float Param::calcValModOf(float macro) const noexcept
@@ -383,7 +428,17 @@ namespace param
 
 	float Param::getValModDenorm() const noexcept
 	{
-		return range.convertFrom0to1(valMod.load());
+		return valModDenorm.load();
+	}
+
+	void Param::denormalize(float* buffer, int numSamples) const noexcept
+	{
+		kernel(buffer, numSamples);
+	}
+
+	void Param::setKernel(makeRange::Kernel&& k) noexcept
+	{
+		kernel = std::move(k);
 	}
 
 	void Param::setModBias(float b) noexcept
@@ -393,6 +448,8 @@ namespace param
 
 		b = juce::jlimit(BiasEps, 1.f - BiasEps, b);
 		modBias.store(b);
+		dirty.store(true);
+		changed();
 	}
 
 	float Param::getModBias() const noexcept
@@ -410,10 +467,22 @@ namespace param
 		valDenormDefault = range.convertFrom0to1(norm);
 	}
 
-	// called by processor to update modulation value(s)
-	void Param::modulate(float macro) noexcept
+	// called by processor to update modulation value(s), returns true if valMod changed
+	bool Param::modulate(float macro, bool macroChanged) noexcept
 	{
-		valMod.store(calcValModOf(macro));
+		const auto wasDirty = dirty.exchange(false);
+		if (!wasDirty)
+			if (!macroChanged || maxModDepth.load() == 0.f)
+				return false;
+
+		const auto vm = calcValModOf(macro);
+		if (vm == valMod.load())
+			return false;
+
+		valMod.store(vm);
+		valModDenorm.store(range.convertFrom0to1(vm));
+		changed();
+		return true;
 	}
 
 	float Param::getDefaultValue() const
@@ -476,6 +545,7 @@ namespace param
 	void Param::setLocked(bool e) noexcept
 	{
 		locked.store(e);
+		changed();
 	}
 
 	void Param::switchLock() noexcept
@@ -483,6 +553,16 @@ namespace param
 		setLocked(!isLocked());
 	}
 
+	unsigned int Param::getChangeSequence() const noexcept
+	{
+		return changeSequence.load();
+	}
+
+	void Param::changed() noexcept
+	{
+		changeSequence.fetch_add(1, std::memory_order_relaxed);
+	}
+
 	String Param::getIDString(PID pID)
 	{
 		return "params/" + toID(toString(pID));
@@ -1335,6 +1415,15 @@ namespace param
 		return new Param(id, range, valDenormDefault, valToStrFunc, strToValFunc, state, Unit::Custom);
 	}
 
+	/* pID, state, valDenormDefault, ranged (range and batch kernel), Unit */
+	extern Param* makeParam(PID id, State& state,
+		float valDenormDefault, makeRange::Ranged&& ranged, Unit unit)
+	{
+		auto param = makeParam(id, state, valDenormDefault, ranged.range, unit);
+		param->setKernel(std::move(ranged.kernel));
+		return param;
+	}
+
 	// PARAMS
 
 	Params::Params(AudioProcessor& audioProcessor, State& _state
@@ -1344,6 +1433,7 @@ namespace param
 	) :
 		params(),
 		state(_state),
+		modDepthLockedKey(getIDString(), "moddepthlocked"),
 		modDepthLocked(false)
 	{
 		{ // HIGH LEVEL PARAMS:
@@ -1453,27 +1543,90 @@ namespace param
 			return parse(str, 0.f);
 		};
 		
-		params.push_back(makeParam(PID::RateHz, state, 2.f, makeRange::withCentre(1.f / 1000.f, 40.f, 2.f), Unit::Hz));
-		params.push_back(makeParam(PID::RateBeats, state, 1.f / 4.f, makeRange::beats(32.f, .5f, false) , Unit::Beats));
-		params.push_back(makeParam(PID::Octaves, state, 3.f, makeRange::lin(1.f, 7.f), Unit::Octaves));
-		params.push_back(makeParam(PID::Width, state, .1f, makeRange::quad(0.f, 2.f, 1), Unit::Percent));
+		auto valToStrRetrigMode = [](float v)
+		{
+			const auto i = static_cast<int>(std::round(v));
+			return i == 0 ? String("Off") :
+				i == 1 ? String("Phase") :
+				i == 2 ? String("Reseed") :
+				String("Fade");
+		};
+		auto strToValRetrigMode = [](const String& str)
+		{
+			const auto text = str.toLowerCase();
+			if (text == "off")
+				return 0.f;
+			else if (text == "phase")
+				return 1.f;
+			else if (text == "reseed" || text == "seed")
+				return 2.f;
+			else if (text == "fade" || text == "crossfade")
+				return 3.f;
+
+			auto parse = strToVal::parse();
+			return parse(str, 0.f);
+		};
+
+		auto valToStrRetrigChannel = [](float v)
+		{
+			const auto i = static_cast<int>(std::round(v));
+			return i == 0 ? String("Omni") : String(i);
+		};
+		auto strToValRetrigChannel = [](const String& str)
+		{
+			const auto text = str.toLowerCase();
+			if (text == "omni" || text == "all" || text == "any")
+				return 0.f;
+
+			auto parse = strToVal::parse();
+			return parse(str, 0.f);
+		};
+
+		// the ranged ones can be denormalized per sample with their batch kernels
+		params.push_back(makeParam(PID::RateHz, state, 2.f, makeRange::ranged::withCentre(1.f / 1000.f, 40.f, 2.f), Unit::Hz));
+		params.push_back(makeParam(PID::RateBeats, state, 1.f / 4.f, makeRange::ranged::beats(32.f, .5f, false), Unit::Beats));
+		params.push_back(makeParam(PID::Octaves, state, 3.f, makeRange::ranged::lin(1.f, 7.f), Unit::Octaves));
+		params.push_back(makeParam(PID::Width, state, .1f, makeRange::ranged::quad(0.f, 2.f, 1), Unit::Percent));
 		params.push_back(makeParam(PID::RateType, state, 0.f, makeRange::toggle(), Unit::Power));
-		params.push_back(makeParam(PID::Phase, state, 0.f, makeRange::quad(0.f, 2.f, 1), Unit::Degree));
+		params.push_back(makeParam(PID::Phase, state, 0.f, makeRange::ranged::quad(0.f, 2.f, 1), Unit::Degree));
 		params.push_back(makeParam(PID::Shape, state, 2.f, makeRange::stepped(0.f, 2.f, 1.f), valToStrShape, strToValShape));
 		params.push_back(makeParam(PID::RandType, state, 1.f, makeRange::toggle(), valToStrRandType, strToValRandType));
 
 		params.push_back(makeParam(PID::Orientation, state, 1.f, makeRange::toggle(), Unit::Orientation));
 		params.push_back(makeParam(PID::OutputType, state, 0.f, makeRange::toggle(), valToStrOutputType, strToValOutputType));
+
+		params.push_back(makeParam(PID::ModPerlinRate, state, 0.f, makeRange::lin(-1.f, 1.f), Unit::Percent));
+		params.push_back(makeParam(PID::ModPerlinOctaves, state, 0.f, makeRange::lin(-1.f, 1.f), Unit::Percent));
+		params.push_back(makeParam(PID::ModPerlinPhase, state, 0.f, makeRange::lin(-1.f, 1.f), Unit::Percent));
+		params.push_back(makeParam(PID::ModPerlinWidth, state, 0.f, makeRange::lin(-1.f, 1.f), Unit::Percent));
+		params.push_back(makeParam(PID::ModEnvRate, state, 0.f, makeRange::lin(-1.f, 1.f), Unit::Percent));
+		params.push_back(makeParam(PID::ModEnvOctaves, state, 0.f, makeRange::lin(-1.f, 1.f), Unit::Percent));
+		params.push_back(makeParam(PID::ModEnvPhase, state, 0.f, makeRange::lin(-1.f, 1.f), Unit::Percent));
+		params.push_back(makeParam(PID::ModEnvWidth, state, 0.f, makeRange::lin(-1.f, 1.f), Unit::Percent));
+		params.push_back(makeParam(PID::ModCCRate, state, 0.f, makeRange::lin(-1.f, 1.f), Unit::Percent));
+		params.push_back(makeParam(PID::ModCCOctaves, state, 0.f, makeRange::lin(-1.f, 1.f), Unit::Percent));
+		params.push_back(makeParam(PID::ModCCPhase, state, 0.f, makeRange::lin(-1.f, 1.f), Unit::Percent));
+		params.push_back(makeParam(PID::ModCCWidth, state, 0.f, makeRange::lin(-1.f, 1.f), Unit::Percent));
+		params.push_back(makeParam(PID::RetrigMode, state, 0.f, makeRange::stepped(0.f, 3.f), valToStrRetrigMode, strToValRetrigMode));
+		params.push_back(makeParam(PID::RetrigChannel, state, 0.f, makeRange::stepped(0.f, 16.f), valToStrRetrigChannel, strToValRetrigChannel));
+		params.push_back(makeParam(PID::RetrigKeyLow, state, 0.f, makeRange::stepped(0.f, 127.f), Unit::Note));
+		params.push_back(makeParam(PID::RetrigKeyHigh, state, 127.f, makeRange::stepped(0.f, 127.f), Unit::Note));
 		// LOW LEVEL PARAMS END
 
 		for (auto param : params)
 			audioProcessor.addParameter(param);
+
+		// the params are at fixed offsets of the binary patch format
+		std::vector<String> keys;
+		keys.reserve(params.size());
+		for (auto param : params)
+			keys.push_back(Param::getIDString(param->id));
+		state.setFixedLayout(keys, { "value", "maxmoddepth", "modbias" });
 	}
 
-	void Params::loadPatch(juce::ApplicationProperties& appProps)
+	void Params::loadPatch(sta::Settings& appProps)
 	{
-		const auto idStr = getIDString();
-		const auto mdl = state.get(idStr, "moddepthlocked");
+		const auto mdl = state.get(modDepthLockedKey);
 		if (mdl != nullptr)
 			setModDepthLocked(static_cast<int>(*mdl) != 0);
 
@@ -1481,13 +1634,12 @@ namespace param
 			param->loadPatch(appProps);
 	}
 
-	void Params::savePatch(juce::ApplicationProperties& appProps) const
+	void Params::savePatch(sta::Settings& appProps) const
 	{
 		for (auto param : params)
 			param->savePatch(appProps);
 
-		const auto idStr = getIDString();
-		state.set(idStr, "moddepthlocked", isModDepthLocked() ? 1 : 0);
+		state.set(modDepthLockedKey, isModDepthLocked() ? 1 : 0);
 	}
 
 	String Params::getIDString()
@@ -1531,17 +1683,88 @@ namespace param
 		setModDepthLocked(!isModDepthLocked());
 	}
 
+	// PARAMS SNAPSHOT
+
+	ParamsSnapshot::ParamsSnapshot() :
+		valMod(),
+		valModDenorm(),
+		changed()
+	{
+		valMod.fill(0.f);
+		valModDenorm.fill(0.f);
+		changed.set();
+	}
+
+	float ParamsSnapshot::getValMod(PID pID) const noexcept
+	{
+		return valMod[static_cast<int>(pID)];
+	}
+
+	float ParamsSnapshot::getValModDenorm(PID pID) const noexcept
+	{
+		return valModDenorm[static_cast<int>(pID)];
+	}
+
+	bool ParamsSnapshot::hasChanged(PID pID) const noexcept
+	{
+		return changed[static_cast<int>(pID)];
+	}
+
+	bool ParamsSnapshot::hasChanged(PID first, PID last) const noexcept
+	{
+		for (auto i = static_cast<int>(first); i <= static_cast<int>(last); ++i)
+			if (changed[i])
+				return true;
+		return false;
+	}
+
+	bool ParamsSnapshot::anyChanged() const noexcept
+	{
+		return changed.any();
+	}
+
 	// MACRO PROCESSOR
 
 	MacroProcessor::MacroProcessor(Params& _params) :
-		params(_params)
+		params(_params),
+		snapshot(),
+		macro(-1.f),
+		invalidated(true)
 	{
 	}
 
-	void MacroProcessor::operator()() noexcept
+	const ParamsSnapshot& MacroProcessor::operator()() noexcept
 	{
 		const auto modDepth = params[PID::Macro]->getValue();
+		const auto macroChanged = modDepth != macro;
+		macro = modDepth;
+
+		snapshot.changed.reset();
+		snapshot.valMod[0] = snapshot.valModDenorm[0] = modDepth;
+		snapshot.changed[0] = macroChanged || invalidated;
+
 		for (auto i = 1; i < NumParams; ++i)
-			params[i]->modulate(modDepth);
+		{
+			auto& param = *params[i];
+			if (param.modulate(modDepth, macroChanged) || invalidated)
+			{
+				snapshot.valMod[i] = param.getValMod();
+				snapshot.valModDenorm[i] = param.getValModDenorm();
+				snapshot.changed[i] = true;
+			}
+		}
+
+		invalidated = false;
+		return snapshot;
+	}
+
+	const ParamsSnapshot& MacroProcessor::getSnapshot() const noexcept
+	{
+		return snapshot;
+	}
+
+	void MacroProcessor::invalidate() noexcept
+	{
+		invalidated = true;
 	}
 }
\ No newline at end of file
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <functional>
+#include <bitset>
+#include <array>
 
 #include "juce_core/juce_core.h"
 #include "juce_audio_processors/juce_audio_processors.h"
 
 #include "../arch/State.h"
+#include "../arch/Settings.h"
 #include "../arch/Range.h"
 #include "../audio/XenManager.h"
 
@@ -74,6 +77,15 @@ namespace param
 		Orientation,
 		OutputType,
 
+		// mod matrix depths, source major
+		ModPerlinRate, ModPerlinOctaves, ModPerlinPhase, ModPerlinWidth,
+		ModEnvRate, ModEnvOctaves, ModEnvPhase, ModEnvWidth,
+		ModCCRate, ModCCOctaves, ModCCPhase, ModCCWidth,
+		RetrigMode,
+		RetrigChannel,
+		RetrigKeyLow,
+		RetrigKeyHigh,
+
 		NumParams
 	};
 
@@ -138,6 +150,7 @@ namespace param
 
 	using ParameterBase = juce::AudioProcessorParameter;
 	using State = sta::State;
+	using StateKey = sta::StateKey;
 	using Xen = audio::XenManager&;
 
 	class Param :
@@ -149,9 +162,9 @@ namespace param
 			const ValToStrFunc&, const StrToValFunc&,
 			State&, const Unit = Unit::NumUnits);
 
-		void savePatch(juce::ApplicationProperties&) const;
+		void savePatch(sta::Settings&) const;
 
-		void loadPatch(juce::ApplicationProperties&);
+		void loadPatch(sta::Settings&);
 
 		//called by host, normalized, thread-safe
 		float getValue() const override;
@@ -181,14 +194,19 @@ namespace param
 
 		float getValModDenorm() const noexcept;
 
+		/* buffer, numSamples (normalized in, denormalized out) */
+		void denormalize(float*, int) const noexcept;
+
+		void setKernel(makeRange::Kernel&&) noexcept;
+
 		void setModBias(float) noexcept;
 
 		float getModBias() const noexcept;
 
 		void setDefaultValue(float/*norm*/) noexcept;
 
-		// called by processor to update modulation value(s)
-		void modulate(float/*macro*/) noexcept;
+		// called by processor to update modulation value(s), returns true if valMod changed
+		bool modulate(float/*macro*/, bool/*macroChanged*/) noexcept;
 
 		float getDefaultValue() const override;
 
@@ -214,6 +232,9 @@ namespace param
 		void setLocked(bool) noexcept;
 		void switchLock() noexcept;
 
+		// increments whenever anything the editor displays of this param changes
+		unsigned int getChangeSequence() const noexcept;
+
 		void setModDepthLocked(bool) noexcept;
 
 		float biased(float /*start*/, float /*end*/, float /*bias [0,1]*/, float /*x*/) const noexcept;
@@ -224,15 +245,20 @@ namespace param
 		const Range range;
 	protected:
 		State& state;
+		const StateKey valueKey, maxModDepthKey, modBiasKey;
+		makeRange::Kernel kernel;
 		float valDenormDefault;
-		std::atomic<float> valNorm, maxModDepth, valMod, modBias;
+		std::atomic<float> valNorm, maxModDepth, valMod, valModDenorm, modBias;
 		ValToStrFunc valToStr;
 		StrToValFunc strToVal;
 		Unit unit;
 
-		std::atomic<bool> locked, inGesture;
+		std::atomic<bool> locked, inGesture, dirty;
+		std::atomic<unsigned int> changeSequence;
 
 		bool modDepthLocked;
+
+		void changed() noexcept;
 	};
 
 	struct Params
@@ -246,9 +272,9 @@ namespace param
 #endif
 		);
 
-		void loadPatch(juce::ApplicationProperties&);
+		void loadPatch(sta::Settings&);
 
-		void savePatch(juce::ApplicationProperties&) const;
+		void savePatch(sta::Settings&) const;
 
 		static String getIDString();
 
@@ -271,6 +297,7 @@ namespace param
 		Parameters params;
 
 		State& state;
+		const StateKey modDepthLockedKey;
 		std::atomic<float> modDepthLocked;
 	};
 
@@ -338,13 +365,43 @@ namespace param
 		ValToStrFunc degree();
 	}
 
+	// immutable per-block view of all modulated parameter values.
+	struct ParamsSnapshot
+	{
+		ParamsSnapshot();
+
+		float getValMod(PID) const noexcept;
+
+		float getValModDenorm(PID) const noexcept;
+
+		bool hasChanged(PID) const noexcept;
+
+		/* first, last (inclusive) */
+		bool hasChanged(PID, PID) const noexcept;
+
+		bool anyChanged() const noexcept;
+
+		std::array<float, NumParams> valMod, valModDenorm;
+		std::bitset<NumParams> changed;
+	};
+
 	struct MacroProcessor
 	{
 		MacroProcessor(Params&);
 
-		void operator()() noexcept;
+		// only re-modulates dirty parameters, the rest keep their values.
+		const ParamsSnapshot& operator()() noexcept;
+
+		const ParamsSnapshot& getSnapshot() const noexcept;
+
+		// makes the next snapshot report every parameter as changed
+		void invalidate() noexcept;
 
 		Params& params;
+	protected:
+		ParamsSnapshot snapshot;
+		float macro;
+		bool invalidated;
 	};
 	
 }
\ No newline at end of file